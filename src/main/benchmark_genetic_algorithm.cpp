@@ -2,6 +2,8 @@
 #include <stopwatch/stopwatch.h>
 #include <cpp-benchmark/benchmark.h>
 #include <cpp-command-line-interface/command_line_interface.h>
+#include <memory>
+#include <thread>
 
 #define DEFAULT_NUMBER_OF_RUNS 10
 #define DEFAULT_STOP_FUNCTION stop_function_factory::numberOfIterations(330)
@@ -29,6 +31,9 @@ cli_main(
 	cli::OptionalArgument<double> mutationProbability(DEFAULT_MUTATION_PROBABILITY, "mutationProbability");
 	cli::FlagArgument useCrossover("useCrossover");
 	cli::FlagArgument useBreadthFirstSearch("useBfs");
+	cli::OptionalArgument<unsigned> relinkingPaths(0, "relinkingPaths");
+	cli::OptionalArgument<size_t> bfsOrders(0, "bfsOrders");
+	cli::OptionalArgument<unsigned> initializationThreads(1, "initializationThreads");
 
 	cli::OptionalArgument<unsigned> numberOfIterationsToStop(0, "iterations");
 	cli::OptionalArgument<unsigned> numberOfIterationsWithoutImprovementToStop(0, "numberOfIterationsWithoutImprovement");
@@ -60,7 +65,11 @@ cli_main(
 		graph = graphBuilder.buildAsAdjacencyList();
 	}
 
-	if (*useBreadthFirstSearch) {
+	if (relinkingPaths.is_present()) {
+		combinationMethod = combination_method_factory::pathRelinking(*relinkingPaths, max(thread::hardware_concurrency(), 1u));
+	} else if (*useBreadthFirstSearch && bfsOrders.is_present()) {
+		combinationMethod = combination_method_factory::breadthFirstSearch(*mutationProbability, make_shared<const BreadthFirstSearchOrders>(*graph, *bfsOrders, max(thread::hardware_concurrency(), 1u)));
+	} else if (*useBreadthFirstSearch) {
 		combinationMethod = combination_method_factory::breadthFirstSearch(*mutationProbability);
 	} else {
 		combinationMethod = combination_method_factory::crossover(*mutationProbability);
@@ -91,7 +100,7 @@ cli_main(
 	benchmark("genetic algorithm", *numberOfRuns) {
 
 		begin = chrono::high_resolution_clock::now();
-		solution = geneticAlgorithm(*graph, *populationSize, stopFunction, combinationMethod);
+		solution = geneticAlgorithm(*graph, *populationSize, stopFunction, combinationMethod, *initializationThreads);
 
 		duration = chrono::high_resolution_clock::now() - begin;
 		penalty = graph->totalPenalty(solution);
@@ -39,14 +39,14 @@ cli_main (
 
 	GraphBuilder graphBuilder;
 	Graph *graph;
-	double randomVariety, heuristicVariety;
-	double randomPenalty, heuristicPenalty;
+	double randomVariety, heuristicVariety, greedyVariety, spanningTreeVariety;
+	double randomPenalty, heuristicPenalty, greedyPenalty, spanningTreePenalty;
 	double lowerBound;
-	list<Solution> randomSolutions, heuristicSolutions;
+	list<Solution> randomSolutions, heuristicSolutions, greedySolutions, spanningTreeSolutions;
 	double varietyFactor, penaltyFactor;
-	chrono::high_resolution_clock::duration randomTime, heuristicTime;
+	chrono::high_resolution_clock::duration randomTime, heuristicTime, greedyTime, spanningTreeTime;
 	chrono::high_resolution_clock::time_point beginTime;
-	double lowerBoundRandomFactor, lowerBoundHeuristicFactor;
+	double lowerBoundRandomFactor, lowerBoundHeuristicFactor, lowerBoundGreedyFactor, lowerBoundSpanningTreeFactor;
 	Solution solution;
 	ifstream fileInputStream;
 
@@ -75,6 +75,16 @@ cli_main (
 	observe_average(heuristicTime, heuristic_time);
 	observe_average(lowerBoundHeuristicFactor, heuristic_lowerbound_factor);
 
+	observe_average(greedyVariety, greedy_variety);
+	observe_average(greedyPenalty, greedy_penalty);
+	observe_average(greedyTime, greedy_time);
+	observe_average(lowerBoundGreedyFactor, greedy_lowerbound_factor);
+
+	observe_average(spanningTreeVariety, spanning_tree_variety);
+	observe_average(spanningTreePenalty, spanning_tree_penalty);
+	observe_average(spanningTreeTime, spanning_tree_time);
+	observe_average(lowerBoundSpanningTreeFactor, spanning_tree_lowerbound_factor);
+
 	observe_average(varietyFactor, heuristic_random_variety_factor);
 	observe_average(penaltyFactor, heuristic_random_penalty_factor);
 
@@ -102,6 +112,26 @@ cli_main (
 
 		heuristicSolutions.push_back(solution);
 
+		beginTime = chrono::high_resolution_clock::now();
+		solution = constructGreedySolution(*graph);
+
+		greedyTime = chrono::high_resolution_clock::now() - beginTime;
+		greedyPenalty = graph->totalPenalty(solution);
+		lowerBoundGreedyFactor = greedyPenalty/lowerBound;
+		greedyVariety = iterativeVariety(*graph, greedySolutions, solution);
+
+		greedySolutions.push_back(solution);
+
+		beginTime = chrono::high_resolution_clock::now();
+		solution = constructSpanningTreeSolution(*graph);
+
+		spanningTreeTime = chrono::high_resolution_clock::now() - beginTime;
+		spanningTreePenalty = graph->totalPenalty(solution);
+		lowerBoundSpanningTreeFactor = spanningTreePenalty/lowerBound;
+		spanningTreeVariety = iterativeVariety(*graph, spanningTreeSolutions, solution);
+
+		spanningTreeSolutions.push_back(solution);
+
 		if (run > 1) {
 			varietyFactor = heuristicVariety/randomVariety;
 		} else {
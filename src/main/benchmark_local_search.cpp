@@ -7,6 +7,8 @@
 #define DEFAULT_NUMBER_OF_RUNS 100
 #define DEFAULT_GRAPH_MODEL GraphModel::ADJACENCY_LIST
 #define DEFAULT_STOP_FUNCTION stop_function_factory::numberOfIterations(10000)
+#define DEFAULT_TABU_TENURE 10
+#define DEFAULT_TABU_CANDIDATE_VERTICES 4
 
 using namespace std;
 using namespace traffic;
@@ -25,12 +27,18 @@ cli_main (
 		cli::OptionalArgument<unsigned> minutesToStop(0, "minutes", "minutes after which local search should stop");
 
 		cli::FlagArgument useAdjacencyMatrix("useAdjacencyMatrix", "use adjacency matrix instead of adjacency list");
+
+		cli::FlagArgument useActiveVertexSearch("useActiveVertexSearch", "use a local search that only revisits vertices whose neighbors changed and stops when no vertex can be improved");
+		cli::FlagArgument useTabuSearch("useTabuSearch", "use tabu search instead of the random descent local search");
+		cli::OptionalArgument<unsigned> tabuTenure(DEFAULT_TABU_TENURE, "tabuTenure", "number of iterations a reverted move stays tabu");
+		cli::OptionalArgument<unsigned> tabuCandidateVertices(DEFAULT_TABU_CANDIDATE_VERTICES, "tabuCandidates", "number of vertices whose timings are all evaluated per tabu search iteration");
 ) {
 
 	GraphBuilder graphBuilder;
 	Graph *graph = nullptr;
 	Solution constructedSolution, searchedSolution;
 	StopFunction stopFunction;
+	ImprovementMethod improvementMethod;
 	double initialConstructionPenalty, localSearchPenalty, lowerBound;
 	double penaltyFactor, lowerBoundFactor;
 	chrono::high_resolution_clock::time_point beginSearch;
@@ -57,6 +65,14 @@ cli_main (
 		stopFunction = DEFAULT_STOP_FUNCTION;
 	}
 
+	if (*useTabuSearch) {
+		improvementMethod = improvement_method_factory::tabuSearch(*tabuTenure, *tabuCandidateVertices);
+	} else if (*useActiveVertexSearch) {
+		improvementMethod = improvement_method_factory::activeVertexLocalSearch();
+	} else {
+		improvementMethod = improvement_method_factory::localSearch();
+	}
+
 	TerminalObserver terminalObserver;
 	register_observers(terminalObserver);
 
@@ -71,7 +87,7 @@ cli_main (
 
 		beginSearch = chrono::high_resolution_clock::now();
 		constructedSolution = constructHeuristicSolution(*graph);
-		searchedSolution = localSearchHeuristic(*graph, constructedSolution, stopFunction);
+		searchedSolution = improvementMethod(*graph, constructedSolution, stopFunction);
 
 		searchDuration = chrono::high_resolution_clock::now() - beginSearch;
 		initialConstructionPenalty = graph->totalPenalty(constructedSolution);
@@ -0,0 +1,110 @@
+#include "heuristic/heuristic.h"
+#include <stopwatch/stopwatch.h>
+#include <cpp-benchmark/benchmark.h>
+#include <cpp-command-line-interface/command_line_interface.h>
+#include <fstream>
+#include <thread>
+
+#define DEFAULT_NUMBER_OF_RUNS 10
+#define DEFAULT_SECONDS_TO_STOP 10
+#define DEFAULT_LOCAL_SEARCH_ITERATIONS 200000
+#define DEFAULT_PRUNING_TOLERANCE 0.05
+#define DEFAULT_NUMBER_OF_THREADS std::thread::hardware_concurrency()
+#define DEFAULT_TABU_TENURE 10
+#define DEFAULT_TABU_CANDIDATE_VERTICES 4
+
+using namespace std;
+using namespace traffic;
+using namespace benchmark;
+using namespace heuristic;
+
+cli_main (
+	"benchmark_multi_start",
+	"undefined",
+	"Benchmark parallel multi-start local search for the simplified traffic light problem",
+
+	cli::RequiredArgument<string> inputPath("input", "path to file containing the problem instance");
+	cli::OptionalArgument<unsigned> numberOfRuns(DEFAULT_NUMBER_OF_RUNS, "runs", "number of times to execute benchmark");
+
+	cli::FlagArgument useAdjacencyMatrix("useAdjacencyMatrix", "use adjacency matrix instead of adjacency list");
+
+	cli::OptionalArgument<unsigned> secondsToStop(DEFAULT_SECONDS_TO_STOP, "seconds", "wall-clock budget of each run, in seconds");
+	cli::OptionalArgument<unsigned> minutesToStop(0, "minutes", "wall-clock budget of each run, in minutes");
+
+	cli::OptionalArgument<unsigned> localSearchIterations(DEFAULT_LOCAL_SEARCH_ITERATIONS, "localSearchIterations", "maximum number of improvement iterations for each start");
+	cli::OptionalArgument<double> pruningTolerance(DEFAULT_PRUNING_TOLERANCE, "pruningTolerance", "abandon a start once its penalty is this fraction above the best penalty found");
+
+	cli::FlagArgument useGreedyConstruction("useGreedyConstruction", "construct initial solutions by giving each vertex, in breadth-first order, its optimal timing against already visited neighbors");
+	cli::FlagArgument useActiveVertexSearch("useActiveVertexSearch", "use a local search that only revisits vertices whose neighbors changed and stops when no vertex can be improved");
+	cli::FlagArgument useTabuSearch("useTabuSearch", "use tabu search as improvement method. Default improvement method is a random descent local search");
+	cli::OptionalArgument<unsigned> tabuTenure(DEFAULT_TABU_TENURE, "tabuTenure", "number of iterations a reverted move stays tabu");
+	cli::OptionalArgument<unsigned> tabuCandidateVertices(DEFAULT_TABU_CANDIDATE_VERTICES, "tabuCandidates", "number of vertices whose timings are all evaluated per tabu search iteration");
+
+	cli::OptionalArgument<unsigned> numberOfThreads(DEFAULT_NUMBER_OF_THREADS, "threads", "specify number of threads");
+) {
+
+	GraphBuilder graphBuilder;
+	Graph *graph = nullptr;
+	Solution solution;
+	ImprovementMethod improvementMethod;
+	ConstructionMethod constructionMethod;
+	chrono::high_resolution_clock::duration timeBudget;
+	double penalty, lowerBound, lowerBoundFactor;
+	chrono::high_resolution_clock::time_point begin;
+	chrono::high_resolution_clock::duration duration;
+	ifstream graphFile;
+
+	graphFile.open(*inputPath);
+	graphBuilder.read_from_file(graphFile);
+
+	if (*useAdjacencyMatrix) {
+		graph = graphBuilder.buildAsAdjacencyMatrix();
+	} else {
+		graph = graphBuilder.buildAsAdjacencyList();
+	}
+
+	if (minutesToStop.is_present()) {
+		timeBudget = chrono::minutes(*minutesToStop);
+	} else {
+		timeBudget = chrono::seconds(*secondsToStop);
+	}
+
+	if (*useTabuSearch) {
+		improvementMethod = improvement_method_factory::tabuSearch(*tabuTenure, *tabuCandidateVertices);
+	} else if (*useActiveVertexSearch) {
+		improvementMethod = improvement_method_factory::activeVertexLocalSearch();
+	} else {
+		improvementMethod = improvement_method_factory::localSearch();
+	}
+
+	if (*useGreedyConstruction) {
+		constructionMethod = construction_method_factory::greedySolution();
+	} else {
+		constructionMethod = construction_method_factory::heuristicSolution();
+	}
+
+	[[maybe_unused]] TerminalObserver terminalObserver;
+	register_observers(terminalObserver);
+
+	observe(lowerBound, lower_bound);
+	observe(penalty, current_penalty);
+	observe_average(penalty, avg_penalty);
+	observe_minimum(penalty, min_penalty);
+	observe_average(lowerBoundFactor, lower_bound_factor);
+	observe_average(duration, avg_duration);
+
+	lowerBound = graph->lowerBound();
+	benchmark("multi-start local search", *numberOfRuns) {
+
+		begin = chrono::high_resolution_clock::now();
+		solution = parallel::multiStartLocalSearch(*graph, timeBudget, *localSearchIterations, *pruningTolerance, *numberOfThreads, improvementMethod, constructionMethod);
+
+		duration = chrono::high_resolution_clock::now() - begin;
+		penalty = graph->totalPenalty(solution);
+		lowerBoundFactor = penalty/lowerBound;
+	};
+
+	delete graph;
+
+	return 0;
+} end_cli_main;
@@ -0,0 +1,122 @@
+#include "heuristic/heuristic.h"
+#include <stopwatch/stopwatch.h>
+#include <cpp-benchmark/benchmark.h>
+#include <cpp-command-line-interface/command_line_interface.h>
+#include <fstream>
+#include <thread>
+
+#define DEFAULT_NUMBER_OF_RUNS 10
+#define DEFAULT_COARSEST_NUMBER_OF_VERTICES 1000
+#define DEFAULT_STOP_FUNCTION stop_function_factory::numberOfIterations(20)
+#define DEFAULT_ELITE_POPULATION_SIZE 16
+#define DEFAULT_DIVERSE_POPULATION_SIZE 64
+#define DEFAULT_LOCAL_SEARCH_ITERATIONS 20000
+#define DEFAULT_NUMBER_OF_THREADS std::thread::hardware_concurrency()
+#define DEFAULT_MUTATION_PROBABILITY 0.595
+
+using namespace std;
+using namespace traffic;
+using namespace benchmark;
+using namespace heuristic;
+
+cli_main (
+	"benchmark_multilevel_search",
+	"undefined",
+	"Benchmark multilevel scatter search for the simplified traffic light problem",
+
+	cli::RequiredArgument<string> inputPath("input", "path to file containing the problem instance");
+	cli::OptionalArgument<unsigned> numberOfRuns(DEFAULT_NUMBER_OF_RUNS, "runs", "number of times to execute benchmark");
+
+	cli::FlagArgument useAdjacencyMatrix("useAdjacencyMatrix", "use adjacency matrix instead of adjacency list");
+
+	cli::OptionalArgument<Vertex> coarsestNumberOfVertices(DEFAULT_COARSEST_NUMBER_OF_VERTICES, "coarsest", "coarsen the graph until it has at most this number of vertices");
+
+	cli::OptionalArgument<unsigned> numberOfIterationsToStop(0, "iterations", "stop the scatter search of the coarsest level after specified number of iterations");
+	cli::OptionalArgument<unsigned> secondsToStop(0, "seconds", "seconds after which to stop the scatter search of the coarsest level");
+
+	cli::OptionalArgument<double> mutationProbability(DEFAULT_MUTATION_PROBABILITY, "mutationProbability", "mutation probability to use during combination");
+	cli::OptionalArgument<size_t> elitePopulationSize(DEFAULT_ELITE_POPULATION_SIZE, "elite", "specify size for the elite population");
+	cli::OptionalArgument<size_t> diversePopulationSize(DEFAULT_DIVERSE_POPULATION_SIZE, "diverse", "specify size for the diverse population");
+	cli::OptionalArgument<unsigned> localSearchIterations(DEFAULT_LOCAL_SEARCH_ITERATIONS, "localSearchIterations", "specify number of iterations the improvement method should execute");
+	cli::FlagArgument useGreedyConstruction("useGreedyConstruction", "construct initial solutions by giving each vertex, in breadth-first order, its optimal timing against already visited neighbors");
+	cli::FlagArgument useActiveVertexSearch("useActiveVertexSearch", "use a local search that only revisits vertices whose neighbors changed");
+
+	cli::OptionalArgument<unsigned> numberOfThreads(DEFAULT_NUMBER_OF_THREADS, "threads", "specify number of threads for the scatter search of the coarsest level");
+) {
+
+	GraphBuilder graphBuilder;
+	Graph *graph = nullptr;
+	Solution solution;
+	StopFunction stopFunction;
+	CombinationMethod combinationMethod;
+	ImprovementMethod improvementMethod;
+	ConstructionMethod constructionMethod, coarsestLevelMethod;
+	double penalty, lowerBound, lowerBoundFactor;
+	chrono::high_resolution_clock::time_point begin;
+	chrono::high_resolution_clock::duration duration;
+	ifstream graphFile;
+
+	graphFile.open(*inputPath);
+	graphBuilder.read_from_file(graphFile);
+
+	if (*useAdjacencyMatrix) {
+		graph = graphBuilder.buildAsAdjacencyMatrix();
+	} else {
+		graph = graphBuilder.buildAsAdjacencyList();
+	}
+
+	if (numberOfIterationsToStop.is_present()) {
+		stopFunction = stop_function_factory::numberOfIterations(*numberOfIterationsToStop);
+	} else if (secondsToStop.is_present()) {
+		stopFunction = stop_function_factory::executionTime(chrono::seconds(*secondsToStop));
+	} else {
+		stopFunction = DEFAULT_STOP_FUNCTION;
+	}
+
+	combinationMethod = combination_method_factory::breadthFirstSearch(*mutationProbability);
+
+	if (*useActiveVertexSearch) {
+		improvementMethod = improvement_method_factory::activeVertexLocalSearch();
+	} else {
+		improvementMethod = improvement_method_factory::localSearch();
+	}
+
+	if (*useGreedyConstruction) {
+		constructionMethod = construction_method_factory::greedySolution();
+	} else {
+		constructionMethod = construction_method_factory::heuristicSolution();
+	}
+
+	coarsestLevelMethod = [&](const Graph& coarsestGraph) -> Solution {
+		if (*numberOfThreads < 2) {
+			return scatterSearch(coarsestGraph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod, improvementMethod, constructionMethod);
+		} else {
+			return parallel::scatterSearch(coarsestGraph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod, *numberOfThreads, improvementMethod, constructionMethod);
+		}
+	};
+
+	[[maybe_unused]] TerminalObserver terminalObserver;
+	register_observers(terminalObserver);
+
+	observe(lowerBound, lower_bound);
+	observe(penalty, current_penalty);
+	observe_average(penalty, avg_penalty);
+	observe_minimum(penalty, min_penalty);
+	observe_average(lowerBoundFactor, lower_bound_factor);
+	observe_average(duration, avg_duration);
+
+	lowerBound = graph->lowerBound();
+	benchmark("multilevel scatter search", *numberOfRuns) {
+
+		begin = chrono::high_resolution_clock::now();
+		solution = multilevelSearch(*graph, *coarsestNumberOfVertices, coarsestLevelMethod);
+
+		duration = chrono::high_resolution_clock::now() - begin;
+		penalty = graph->totalPenalty(solution);
+		lowerBoundFactor = penalty/lowerBound;
+	};
+
+	delete graph;
+
+	return 0;
+} end_cli_main;
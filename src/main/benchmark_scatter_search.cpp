@@ -3,6 +3,7 @@
 #include <cpp-benchmark/benchmark.h>
 #include <cpp-command-line-interface/command_line_interface.h>
 #include <fstream>
+#include <memory>
 #include <thread>
 
 #define DEFAULT_NUMBER_OF_RUNS 10
@@ -12,6 +13,11 @@
 #define DEFAULT_LOCAL_SEARCH_ITERATIONS 20000
 #define DEFAULT_NUMBER_OF_THREADS std::thread::hardware_concurrency()
 #define DEFAULT_MUTATION_PROBABILITY 0.595
+#define DEFAULT_TABU_TENURE 10
+#define DEFAULT_TABU_CANDIDATE_VERTICES 4
+#define DEFAULT_SOCKET_DIRECTORY "/tmp"
+#define DEFAULT_MIGRATION_INTERVAL 5
+#define DEFAULT_NUMBER_OF_MIGRANTS 2
 
 #define DONT_OUTPUT_TO_FILE ""
 
@@ -39,12 +45,35 @@ cli_main (
 
 	cli::OptionalArgument<double> mutationProbability(DEFAULT_MUTATION_PROBABILITY, "mutationProbability", "mutation probability to use during combination");
 	cli::FlagArgument useCrossover("useCrossover", "use crossover as combination method. Default combination is a Breadth-First search combination");
+	cli::OptionalArgument<unsigned> relinkingPaths(0, "relinkingPaths", "use path relinking as combination method, keeping the best of the specified number of paths, explored concurrently when threads are available");
+	cli::OptionalArgument<size_t> bfsOrders(0, "bfsOrders", "precompute the specified number of breadth-first orders for the Breadth-First search combination instead of traversing the graph on every combination");
 
 	cli::OptionalArgument<size_t> elitePopulationSize(DEFAULT_ELITE_POPULATION_SIZE, "elite", "specify size for the elite population");
 	cli::OptionalArgument<size_t> diversePopulationSize(DEFAULT_DIVERSE_POPULATION_SIZE, "diverse", "specify size for the diverse population");
 	cli::OptionalArgument<unsigned> localSearchIterations(DEFAULT_LOCAL_SEARCH_ITERATIONS, "localSearchIterations", "specify number of iterations the improvement method should execute");
+	cli::OptionalArgument<size_t> sketchSize(0, "sketchSize", "number of sampled vertices used to approximate distances during diversification, 0 for exact distances");
+	cli::FlagArgument useSpanningTreeForDiverse("useSpanningTreeForDiverse", "construct the diverse population from random spanning trees. Default construction is the same as the elite population");
+	cli::FlagArgument useGreedyConstruction("useGreedyConstruction", "construct initial solutions by giving each vertex, in breadth-first order, its optimal timing against already visited neighbors");
+	cli::FlagArgument useActiveVertexSearch("useActiveVertexSearch", "use a local search that only revisits vertices whose neighbors changed and stops when no vertex can be improved");
+	cli::FlagArgument useTabuSearch("useTabuSearch", "use tabu search as improvement method. Default improvement method is a random descent local search");
+	cli::OptionalArgument<unsigned> tabuTenure(DEFAULT_TABU_TENURE, "tabuTenure", "number of iterations a reverted move stays tabu");
+	cli::OptionalArgument<unsigned> tabuCandidateVertices(DEFAULT_TABU_CANDIDATE_VERTICES, "tabuCandidates", "number of vertices whose timings are all evaluated per tabu search iteration");
 
 	cli::OptionalArgument<unsigned> numberOfThreads(DEFAULT_NUMBER_OF_THREADS, "threads", "specify number of threads");
+	cli::FlagArgument useAsynchronousSearch("asynchronous", "let every thread insert offspring into a shared reference set as soon as they are improved, without waiting for the other threads");
+
+	cli::OptionalArgument<string> exchangeTopology("tree", "exchangeTopology", "how threads exchange individuals: tree stops every thread to merge their discarded individuals, ring, hypercube and randomPairs send migrants to neighbors without stopping");
+	cli::OptionalArgument<unsigned> exchangeInterval(1, "exchangeInterval", "iterations between two exchanges between threads, 0 to only exchange on stagnation");
+	cli::OptionalArgument<unsigned> exchangeOnStagnation(0, "exchangeOnStagnation", "also exchange once the best penalty has not improved for the specified number of iterations");
+	cli::OptionalArgument<size_t> exchangeMigrants(2, "exchangeMigrants", "number of elite and of diverse individuals a thread sends its neighbor on each exchange");
+	cli::FlagArgument pinThreads("pinThreads", "pin every thread to a cpu, spreading them over the NUMA nodes, and move each sub-population to the memory of the node searching it");
+	cli::FlagArgument replicateGraph("replicateGraph", "with pinThreads, give every NUMA node its own copy of the graph");
+
+	cli::OptionalArgument<unsigned> numberOfIslands(0, "islands", "run as one island of an island model with the specified number of islands, each a separate process on this machine sending migrants to the next in a ring");
+	cli::OptionalArgument<unsigned> islandIndex(0, "island", "index of this island, from 0 to islands-1");
+	cli::OptionalArgument<string> socketDirectory(DEFAULT_SOCKET_DIRECTORY, "socketDirectory", "directory holding the Unix domain socket of every island");
+	cli::OptionalArgument<unsigned> migrationInterval(DEFAULT_MIGRATION_INTERVAL, "migrationInterval", "iterations between two migrations");
+	cli::OptionalArgument<size_t> numberOfMigrants(DEFAULT_NUMBER_OF_MIGRANTS, "migrants", "number of elite and of diverse individuals sent on each migration");
 ) {
 
 	GraphBuilder graphBuilder;
@@ -52,6 +81,11 @@ cli_main (
 	Solution solution;
 	StopFunction stopFunction;
 	CombinationMethod combinationMethod;
+	ImprovementMethod improvementMethod;
+	ConstructionMethod constructionMethod, diverseConstructionMethod;
+	parallel::IslandMigration migration;
+	parallel::MigrationPolicy migrationPolicy;
+	parallel::NumaPlacement numaPlacement;
 	double penalty, lowerBound;
 	chrono::high_resolution_clock::time_point begin;
 	chrono::high_resolution_clock::duration duration;
@@ -78,12 +112,66 @@ cli_main (
 		stopFunction = DEFAULT_STOP_FUNCTION;
 	}
 
-	if (*useCrossover) {
+	if (relinkingPaths.is_present()) {
+		combinationMethod = combination_method_factory::pathRelinking(*relinkingPaths, *numberOfThreads);
+	} else if (*useCrossover) {
 		combinationMethod = combination_method_factory::crossover(*mutationProbability);
+	} else if (bfsOrders.is_present()) {
+		combinationMethod = combination_method_factory::breadthFirstSearch(*mutationProbability, make_shared<const BreadthFirstSearchOrders>(*graph, *bfsOrders, *numberOfThreads));
 	} else {
 		combinationMethod = combination_method_factory::breadthFirstSearch(*mutationProbability);
 	}
 
+	if (*useTabuSearch) {
+		improvementMethod = improvement_method_factory::tabuSearch(*tabuTenure, *tabuCandidateVertices);
+	} else if (*useActiveVertexSearch) {
+		improvementMethod = improvement_method_factory::activeVertexLocalSearch();
+	} else {
+		improvementMethod = improvement_method_factory::localSearch();
+	}
+
+	if (*useGreedyConstruction) {
+		constructionMethod = construction_method_factory::greedySolution();
+	} else {
+		constructionMethod = construction_method_factory::heuristicSolution();
+	}
+
+	if (*useSpanningTreeForDiverse) {
+		diverseConstructionMethod = construction_method_factory::spanningTreeSolution();
+	} else {
+		diverseConstructionMethod = constructionMethod;
+	}
+
+	if (*exchangeTopology == "tree") {
+		migrationPolicy.topology = parallel::MigrationPolicy::TREE;
+	} else if (*exchangeTopology == "ring") {
+		migrationPolicy.topology = parallel::MigrationPolicy::RING;
+	} else if (*exchangeTopology == "hypercube") {
+		migrationPolicy.topology = parallel::MigrationPolicy::HYPERCUBE;
+	} else if (*exchangeTopology == "randomPairs") {
+		migrationPolicy.topology = parallel::MigrationPolicy::RANDOM_PAIRS;
+	} else {
+		throw invalid_argument("unknown exchange topology: " + *exchangeTopology);
+	}
+	migrationPolicy.interval = *exchangeInterval;
+	migrationPolicy.stagnation = *exchangeOnStagnation;
+	migrationPolicy.numberOfMigrants = *exchangeMigrants;
+	numaPlacement.pinThreads = *pinThreads;
+	numaPlacement.replicateGraph = *replicateGraph;
+
+	if (numberOfIslands.is_present()) {
+		auto islandSocketPath = [&](unsigned island) {
+			return *socketDirectory + "/traffic_island_" + to_string(island) + ".sock";
+		};
+		vector<string> neighborPaths;
+		if (*numberOfIslands > 1) {
+			neighborPaths.push_back(islandSocketPath((*islandIndex+1) % *numberOfIslands));
+		}
+		migration.transport = make_shared<UnixSocketTransport>(islandSocketPath(*islandIndex), neighborPaths);
+		migration.interval = *migrationInterval;
+		migration.numberOfMigrants = *numberOfMigrants;
+	}
+
 	TerminalObserver terminalObserver;
 
 	register_observers(terminalObserver);
@@ -106,10 +194,14 @@ cli_main (
 
 		begin = chrono::high_resolution_clock::now();
 
-		if (*numberOfThreads < 2) {
-			solution = scatterSearch(*graph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod);
+		if (numberOfIslands.is_present()) {
+			solution = parallel::islandScatterSearch(*graph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod, *numberOfThreads, migration, improvementMethod, constructionMethod, diverseConstructionMethod, *sketchSize, migrationPolicy, numaPlacement);
+		} else if (*useAsynchronousSearch) {
+			solution = parallel::asynchronousScatterSearch(*graph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod, *numberOfThreads, improvementMethod, constructionMethod, diverseConstructionMethod);
+		} else if (*numberOfThreads < 2) {
+			solution = scatterSearch(*graph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod, improvementMethod, constructionMethod, diverseConstructionMethod, *sketchSize);
 		} else {
-			solution = parallel::scatterSearch(*graph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod, *numberOfThreads);
+			solution = parallel::scatterSearch(*graph, *elitePopulationSize, *diversePopulationSize, *localSearchIterations, stopFunction, combinationMethod, *numberOfThreads, improvementMethod, constructionMethod, diverseConstructionMethod, *sketchSize, migrationPolicy, numaPlacement);
 		}
 
 		duration = chrono::high_resolution_clock::now() - begin;
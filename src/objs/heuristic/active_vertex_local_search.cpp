@@ -0,0 +1,121 @@
+#include "heuristic.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace traffic;
+using namespace heuristic;
+using namespace std;
+
+/*
+ * Queue of the vertices waiting to be improved, kept per thread so that searches called once per individual reuse its buffers.
+ * A vertex is in the queue at most once, so V slots are used as a ring buffer
+ */
+struct ActiveVertexQueue {
+	vector<bool> isActive;
+	vector<Vertex> ring;
+	size_t head = 0;
+	size_t size = 0;
+	mt19937 randomEngine{random_device()()};
+
+	void reset(Vertex nVertices) {
+		this->isActive.assign(nVertices, false);
+		this->ring.resize(nVertices);
+		this->head = 0;
+		this->size = 0;
+	}
+
+	inline void push(Vertex vertex) {
+		if (!this->isActive[vertex]) {
+			this->isActive[vertex] = true;
+			this->ring[(this->head + this->size)%this->ring.size()] = vertex;
+			this->size++;
+		}
+	}
+
+	inline Vertex pop() {
+		Vertex vertex = this->ring[this->head];
+		this->head = (this->head + 1)%this->ring.size();
+		this->size--;
+		this->isActive[vertex] = false;
+		return vertex;
+	}
+
+	// every vertex starts active, in random order
+	void pushShuffledVertices(Vertex nVertices) {
+		for (Vertex v = 0; v < nVertices; v++) {
+			this->push(v);
+		}
+		shuffle(this->ring.begin(), this->ring.begin() + nVertices, this->randomEngine);
+	}
+};
+
+// the queue of the calling thread, emptied for a graph of nVertices
+ActiveVertexQueue& emptyActiveVertexQueue(Vertex nVertices) {
+	thread_local ActiveVertexQueue activeVertices;
+	activeVertices.reset(nVertices);
+	return activeVertices;
+}
+
+/*
+ * A vertex that has no improving move stays locally optimal until one of its neighbors changes timing,
+ * so only vertices with a recently changed neighbor are kept in the queue.
+ * Each dequeued vertex is moved to its optimal timing, and its neighbors are enqueued if that lowered the penalty
+ */
+template<typename StopPolicy>
+void activeVertexSearch(const Graph& graph, Solution& solution, ActiveVertexQueue& activeVertices, StopPolicy stopCriteriaNotMet) {
+	Perturbation bestPerturbation;
+	Vertex vertex;
+	Metrics metrics;
+
+	metrics.numberOfIterations = 0;
+	metrics.numberOfIterationsWithoutImprovement = 0;
+	metrics.executionBegin = chrono::high_resolution_clock::now();
+	while (activeVertices.size > 0 && stopCriteriaNotMet(metrics)) {
+		vertex = activeVertices.pop();
+
+		bestPerturbation = optimalTiming(graph, vertex, solution);
+
+		metrics.numberOfIterations++;
+		if (bestPerturbation.penalty < graph.vertexPenalty(vertex, solution)) {
+			solution[vertex] = bestPerturbation.timing;
+			for (auto& neighbor : graph.neighborsOf(vertex)) {
+				activeVertices.push(neighbor.first);
+			}
+			metrics.numberOfIterationsWithoutImprovement = 0;
+		} else {
+			metrics.numberOfIterationsWithoutImprovement++;
+		}
+	}
+}
+
+void heuristic::activeVertexLocalSearchInPlace(const Graph& graph, Solution& solution) {
+	auto& activeVertices = emptyActiveVertexQueue(graph.getNumberOfVertices());
+	activeVertices.pushShuffledVertices(graph.getNumberOfVertices());
+	activeVertexSearch(graph, solution, activeVertices, [](const Metrics&) { return true; });
+}
+
+Solution heuristic::activeVertexLocalSearch(const Graph& graph, const Solution& initialSolution) {
+	Solution solution(initialSolution);
+	activeVertexLocalSearchInPlace(graph, solution);
+	return solution;
+}
+
+Solution heuristic::activeVertexLocalSearch(const Graph& graph, const Solution& initialSolution, const StopFunction& stopCriteriaNotMet) {
+	Solution solution(initialSolution);
+	auto& activeVertices = emptyActiveVertexQueue(graph.getNumberOfVertices());
+	activeVertices.pushShuffledVertices(graph.getNumberOfVertices());
+	activeVertexSearch(graph, solution, activeVertices, cref(stopCriteriaNotMet));
+	return solution;
+}
+
+Solution heuristic::activeVertexLocalSearch(const Graph& graph, const Solution& initialSolution, const vector<Vertex>& initiallyActiveVertices) {
+	Solution solution(initialSolution);
+	auto& activeVertices = emptyActiveVertexQueue(graph.getNumberOfVertices());
+	for (auto v : initiallyActiveVertices) {
+		activeVertices.push(v);
+	}
+	activeVertexSearch(graph, solution, activeVertices, [](const Metrics&) { return true; });
+	return solution;
+}
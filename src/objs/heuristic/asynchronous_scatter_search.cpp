@@ -0,0 +1,176 @@
+#include "heuristic.h"
+#include "parallel_scatter_search.h"
+#include "../parallel/macros.h"
+#include "../parallel/reusable_thread.h"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <random>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+using namespace ::parallel;
+
+/*
+ * A reference set entry. Solutions are immutable once published, so readers only hold the lock
+ * long enough to copy the pointer, and the penalty can be scanned without locking at all
+ */
+struct ReferenceSlot {
+	mutex lock;
+	shared_ptr<const Solution> solution;
+	atomic<TimeUnit> penalty;
+};
+
+shared_ptr<const Solution> snapshot (ReferenceSlot& slot) {
+	lock_guard<mutex> guard(slot.lock);
+	return slot.solution;
+}
+
+/*
+ * The offspring replaces the worst elite individual if it is better. Otherwise it replaces the diverse individual closest to it
+ * when it has a lower penalty, so similar solutions compete with each other and the diverse set keeps its spread.
+ * Returns whether the offspring entered the elite set
+ */
+bool insertOffspring (const Graph& graph, vector<ReferenceSlot>& referenceSet, size_t elitePopulationSize, shared_ptr<const Solution> offspring, TimeUnit penalty) {
+	while (true) {
+		size_t worstElite = 0;
+		for (size_t i = 1; i < elitePopulationSize; i++) {
+			if (referenceSet[i].penalty.load() > referenceSet[worstElite].penalty.load()) {
+				worstElite = i;
+			}
+		}
+
+		auto& slot = referenceSet[worstElite];
+		if (penalty >= slot.penalty.load()) {
+			break;
+		}
+
+		lock_guard<mutex> guard(slot.lock);
+		// another thread may have replaced it since the scan, in which case the scan is repeated
+		if (penalty < slot.penalty.load()) {
+			slot.solution = offspring;
+			slot.penalty.store(penalty);
+			return true;
+		}
+	}
+
+	size_t closestDiverse = referenceSet.size();
+	shared_ptr<const Solution> closestSolution;
+	TimeUnit closestDistance = numeric_limits<TimeUnit>::max();
+	for (size_t i = elitePopulationSize; i < referenceSet.size(); i++) {
+		auto solution = snapshot(referenceSet[i]);
+		auto currentDistance = distance(graph, *offspring, *solution);
+		if (currentDistance < closestDistance) {
+			closestDistance = currentDistance;
+			closestDiverse = i;
+			closestSolution = solution;
+		}
+	}
+
+	if (closestDiverse < referenceSet.size() && closestDistance > 0) {
+		auto& slot = referenceSet[closestDiverse];
+		lock_guard<mutex> guard(slot.lock);
+		if (slot.solution == closestSolution && penalty < slot.penalty.load()) {
+			slot.solution = offspring;
+			slot.penalty.store(penalty);
+		}
+	}
+	return false;
+}
+
+Solution heuristic::parallel::asynchronousScatterSearch (const Graph &graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const ImprovementMethod &improvementMethod, const ConstructionMethod &constructionMethod, const ConstructionMethod &diverseConstructionMethod) {
+	if (numberOfThreads < 1) {
+		throw invalid_argument("numberOfThreads must be greater than 0");
+	}
+	if (elitePopulationSize < 1) {
+		throw invalid_argument("elitePopulationSize must be greater than 0");
+	}
+	if (elitePopulationSize+diversePopulationSize < 2) {
+		throw invalid_argument("elitePopulationSize+diversePopulationSize must be at least 2");
+	}
+
+	size_t referencePopulationSize = elitePopulationSize+diversePopulationSize;
+	// offspring are counted in generations of the synchronous search, so iteration based stop functions stay comparable
+	size_t generationSize = max(referencePopulationSize/2, (size_t) 1);
+
+	Population<Individual> initialPopulation(referencePopulationSize);
+	vector<ReferenceSlot> referenceSet(referencePopulationSize);
+	StopFunction diverseLocalSearchStopFunction = stop_function_factory::numberOfIterations(localSearchIterations);
+	StopFunction eliteLocalSearchStopFunction = stop_function_factory::numberOfIterations(localSearchIterations*10);
+
+	Metrics metrics;
+	mutex metricsLock;
+	atomic<bool> stopSignal(false);
+	size_t numberOfOffspring = 0, lastImprovement = 0;
+
+	metrics.executionBegin = chrono::high_resolution_clock::now();
+
+	thread_pile threads(numberOfThreads);
+	thread_pile::slice_t allThreads = threads;
+	initializePopulation(graph, {
+		{initialPopulation.slice(0, elitePopulationSize), eliteLocalSearchStopFunction, constructionMethod},
+		{initialPopulation.slice(elitePopulationSize, referencePopulationSize), diverseLocalSearchStopFunction, diverseConstructionMethod}
+	}, allThreads, improvementMethod);
+
+	metrics.numberOfIterations = 0;
+	metrics.numberOfIterationsWithoutImprovement = 0;
+	metrics.penalty = numeric_limits<TimeUnit>::max();
+	for (size_t i = 0; i < referencePopulationSize; i++) {
+		referenceSet[i].penalty.store(initialPopulation[i].penalty);
+		referenceSet[i].solution = make_shared<const Solution>(move(initialPopulation[i].solution));
+		if (i < elitePopulationSize && referenceSet[i].penalty.load() < metrics.penalty) {
+			metrics.penalty = referenceSet[i].penalty.load();
+			metrics.solution = referenceSet[i].solution.get();
+		}
+	}
+	// initialization is the longest stretch without a check, so the first one reports the best elite. Later slots are replaced
+	// while other threads run, so the solution is not shown again
+	stopSignal.store(!stopFunction(metrics));
+	metrics.solution = nullptr;
+
+	using_threads(threads);
+	for_each_thread {
+		CombinationWorkspace workspace;
+		auto& randomEngine = workspace.randomEngine;
+		uniform_int_distribution<size_t> slotPicker(0, referencePopulationSize-1);
+		Solution child;
+
+		while (!stopSignal.load()) {
+			auto parent1 = slotPicker(randomEngine);
+			auto parent2 = slotPicker(randomEngine);
+			while (parent2 == parent1) {
+				parent2 = slotPicker(randomEngine);
+			}
+			auto solution1 = snapshot(referenceSet[parent1]);
+			auto solution2 = snapshot(referenceSet[parent2]);
+
+			combinationMethod(graph, *solution1, *solution2, child, workspace);
+			auto offspring = improvementMethod(graph, child, diverseLocalSearchStopFunction);
+			auto penalty = graph.totalPenalty(offspring);
+			auto enteredElite = insertOffspring(graph, referenceSet, elitePopulationSize, make_shared<const Solution>(move(offspring)), penalty);
+
+			lock_guard<mutex> guard(metricsLock);
+			numberOfOffspring++;
+			if (enteredElite && penalty < metrics.penalty) {
+				metrics.penalty = penalty;
+				lastImprovement = numberOfOffspring;
+			}
+			metrics.numberOfIterations = numberOfOffspring/generationSize;
+			metrics.numberOfIterationsWithoutImprovement = (numberOfOffspring-lastImprovement)/generationSize;
+			if (!stopFunction(metrics)) {
+				stopSignal.store(true);
+			}
+		}
+	} end_for_each_thread;
+
+	size_t bestElite = 0;
+	for (size_t i = 1; i < elitePopulationSize; i++) {
+		if (referenceSet[i].penalty.load() < referenceSet[bestElite].penalty.load()) {
+			bestElite = i;
+		}
+	}
+	return *referenceSet[bestElite].solution;
+}
@@ -0,0 +1,135 @@
+#include "heuristic.h"
+#include "../parallel/macros.h"
+#include "../parallel/reusable_thread.h"
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+using namespace ::parallel;
+
+/*
+ * Calls visit(v, i) for every vertex reachable from root, i being the position of v in breadth-first order.
+ * Only the workspace is used as scratch memory
+ */
+template<typename Visit>
+void forEachInBreadthFirstOrder (const Graph& graph, Vertex root, CombinationWorkspace& workspace, Visit visit) {
+	auto& q = workspace.queue;
+	size_t queueBegin = 0, queueEnd = 0;
+
+	workspace.reset(graph);
+	workspace.visit(root);
+	q[queueEnd++] = root;
+
+	while (queueBegin < queueEnd) {
+		Vertex v = q[queueBegin];
+
+		for (auto& u : graph.neighborsOf(v)) {
+			if (!workspace.isVisited(u.first)) {
+				workspace.visit(u.first);
+				q[queueEnd++] = u.first;
+			}
+		}
+
+		visit(v, queueBegin);
+		queueBegin++;
+	}
+}
+
+size_t firstHalfSize (size_t nVertices) {
+	return nVertices % 2 ? (nVertices / 2) + 1 : nVertices / 2;
+}
+
+BreadthFirstSearchOrders::BreadthFirstSearchOrders (const Graph& graph, size_t numberOfOrders, unsigned numberOfThreads) :
+	graph(&graph),
+	numberOfVertices(graph.getNumberOfVertices()),
+	numberOfOrders(numberOfOrders)
+{
+	if (numberOfOrders < 1) {
+		throw invalid_argument("numberOfOrders must be greater than 0");
+	}
+	if (numberOfThreads < 1) {
+		throw invalid_argument("numberOfThreads must be greater than 0");
+	}
+
+	random_device seeder;
+	mt19937 randomEngine(seeder());
+	uniform_int_distribution<Vertex> rootPicker(0, this->numberOfVertices-1);
+	vector<Vertex> roots(numberOfOrders);
+	for (auto& root : roots) {
+		root = rootPicker(randomEngine);
+	}
+
+	auto middle = firstHalfSize(this->numberOfVertices);
+	this->sides.assign(numberOfOrders*this->numberOfVertices, UNREACHED);
+
+	numberOfThreads = usable_threads(numberOfOrders, numberOfThreads);
+	vector<CombinationWorkspace> workspaces(numberOfThreads);
+	thread_pile threads(numberOfThreads);
+	using_threads(threads);
+	parallel_for ((size_t) 0, numberOfOrders) {
+		auto orderSides = this->sides.data() + i*this->numberOfVertices;
+		forEachInBreadthFirstOrder(graph, roots[i], workspaces[thread_i], [&](Vertex v, size_t position) {
+			orderSides[v] = position < middle ? FIRST : SECOND;
+		});
+	} end_parallel_for;
+}
+
+CombinationMethod combination_method_factory::breadthFirstSearch (double mutationProbability) {
+	return [mutationProbability](const Graph& graph, const Solution &s1, const Solution &s2, Solution &solution, CombinationWorkspace &workspace) {
+		auto& randomEngine = workspace.randomEngine;
+		uniform_int_distribution<Vertex> vertexPicker(0, graph.getNumberOfVertices()-1);
+		uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
+		uniform_real_distribution<decltype(mutationProbability)> mutationPicker(0.0, 1.0);
+		auto middle = firstHalfSize(graph.getNumberOfVertices());
+
+		// vertices the search does not reach keep timing 0
+		solution.assign(graph.getNumberOfVertices(), 0);
+
+		// the first half of the vertices in visiting order take their timings from s1, the rest from s2
+		forEachInBreadthFirstOrder(graph, vertexPicker(randomEngine), workspace, [&](Vertex v, size_t position) {
+			solution[v] = position < middle ? s1[v] : s2[v];
+		});
+
+		if (mutationPicker(randomEngine) <= mutationProbability) {
+			auto vertex = vertexPicker(randomEngine);
+			auto timing = timingPicker(randomEngine);
+			solution[vertex] = timing;
+		}
+	};
+}
+
+CombinationMethod combination_method_factory::breadthFirstSearch (double mutationProbability, shared_ptr<const BreadthFirstSearchOrders> orders) {
+	auto traverse = breadthFirstSearch(mutationProbability);
+
+	return [mutationProbability, orders, traverse](const Graph& graph, const Solution &s1, const Solution &s2, Solution &solution, CombinationWorkspace &workspace) {
+		// graphs other than the one the orders were computed for, such as the subgraphs of a partitioned search, are still traversed
+		if (!orders->isOrderOf(graph)) {
+			traverse(graph, s1, s2, solution, workspace);
+			return;
+		}
+
+		auto& randomEngine = workspace.randomEngine;
+		Vertex nVertices = graph.getNumberOfVertices();
+		uniform_int_distribution<size_t> orderPicker(0, orders->size()-1);
+		uniform_int_distribution<Vertex> vertexPicker(0, nVertices-1);
+		uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
+		uniform_real_distribution<decltype(mutationProbability)> mutationPicker(0.0, 1.0);
+		auto sides = orders->sidesOf(orderPicker(randomEngine));
+
+		solution.resize(nVertices);
+		for (Vertex v = 0; v < nVertices; v++) {
+			solution[v] = sides[v] == BreadthFirstSearchOrders::FIRST ? s1[v] : (sides[v] == BreadthFirstSearchOrders::SECOND ? s2[v] : 0);
+		}
+
+		if (mutationPicker(randomEngine) <= mutationProbability) {
+			auto vertex = vertexPicker(randomEngine);
+			auto timing = timingPicker(randomEngine);
+			solution[vertex] = timing;
+		}
+	};
+}
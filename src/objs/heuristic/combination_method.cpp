@@ -0,0 +1,38 @@
+#include "combination_method.h"
+
+#include <algorithm>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+CombinationWorkspace::CombinationWorkspace (void) :
+	CombinationWorkspace(random_device()())
+{}
+
+CombinationWorkspace::CombinationWorkspace (mt19937::result_type seed) :
+	epoch(0),
+	randomEngine(seed)
+{}
+
+void CombinationWorkspace::reset (const Graph& graph) {
+	Vertex nVertices = graph.getNumberOfVertices();
+	if (this->visitedEpoch.size() < nVertices) {
+		this->visitedEpoch.resize(nVertices, 0);
+		this->queue.resize(nVertices);
+	}
+
+	this->epoch++;
+	// after wrapping around, marks left from 2^32 searches ago would read as visited
+	if (this->epoch == 0) {
+		fill(this->visitedEpoch.begin(), this->visitedEpoch.end(), 0);
+		this->epoch = 1;
+	}
+}
+
+Solution CombinationMethod::operator() (const Graph& graph, const Solution& a, const Solution& b) const {
+	thread_local CombinationWorkspace workspace;
+	Solution output;
+	this->combineInto(graph, a, b, output, workspace);
+	return output;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include <functional>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace heuristic {
+
+	// working copy of one path of a path relinking combination, and the marks and moves of its walk
+	struct RelinkingPath {
+		traffic::Solution solution;
+		traffic::TimeUnit penalty;
+		std::mt19937::result_type seed;
+		std::vector<traffic::Vertex> differingVertices;
+		std::vector<bool> isDiffering;
+		std::vector<traffic::Vertex> moves;
+		std::vector<unsigned> version;
+		// min-heap of (delta, vertex, version) for the greedy walks
+		std::vector<std::tuple<traffic::TimeUnit, traffic::Vertex, unsigned>> bestMoves;
+	};
+
+	/*
+	 * Scratch memory of a combination method, owned by the thread calling it. Its buffers grow to the largest graph combined and are reused
+	 * afterwards, and visited marks are cleared by bumping an epoch instead of refilling them, so steady-state combinations allocate nothing
+	 */
+	class CombinationWorkspace {
+		private:
+			std::vector<unsigned> visitedEpoch;
+			unsigned epoch;
+		public:
+			// every vertex is enqueued at most once per search, so V slots are used as a queue without wrapping around
+			std::vector<traffic::Vertex> queue;
+			std::mt19937 randomEngine;
+			// one per path of a path relinking combination
+			std::vector<RelinkingPath> relinkingPaths;
+
+			CombinationWorkspace (void);
+			explicit CombinationWorkspace (std::mt19937::result_type seed);
+
+			// starts a new search over graph, with every vertex unvisited
+			void reset (const traffic::Graph& graph);
+
+			inline bool isVisited (traffic::Vertex vertex) const {
+				return this->visitedEpoch[vertex] == this->epoch;
+			}
+
+			inline void visit (traffic::Vertex vertex) {
+				this->visitedEpoch[vertex] = this->epoch;
+			}
+	};
+
+	typedef std::function<void(const traffic::Graph&, const traffic::Solution&, const traffic::Solution&, traffic::Solution&, CombinationWorkspace&)> CombinationFunction;
+
+	/*
+	 * Writes the combination of two parents into an output solution, reusing its capacity, with the workspace of the calling thread as scratch memory.
+	 * Functions returning a new solution are still accepted, their result being moved into the output
+	 */
+	class CombinationMethod {
+		private:
+			CombinationFunction combineInto;
+
+			template<typename Function>
+			using writesIntoOutput = std::is_invocable<Function&, const traffic::Graph&, const traffic::Solution&, const traffic::Solution&, traffic::Solution&, CombinationWorkspace&>;
+			template<typename Function>
+			using returnsSolution = std::is_invocable_r<traffic::Solution, Function&, const traffic::Graph&, const traffic::Solution&, const traffic::Solution&>;
+		public:
+			CombinationMethod (void) = default;
+
+			template<typename Function, typename std::enable_if<writesIntoOutput<Function>::value, int>::type = 0>
+			CombinationMethod (Function function) :
+				combineInto(std::move(function))
+			{}
+
+			template<typename Function, typename std::enable_if<!writesIntoOutput<Function>::value && returnsSolution<Function>::value, int>::type = 0>
+			CombinationMethod (Function function) :
+				combineInto([function](const traffic::Graph& graph, const traffic::Solution& a, const traffic::Solution& b, traffic::Solution& output, CombinationWorkspace&) {
+					output = function(graph, a, b);
+				})
+			{}
+
+			inline void operator() (const traffic::Graph& graph, const traffic::Solution& a, const traffic::Solution& b, traffic::Solution& output, CombinationWorkspace& workspace) const {
+				this->combineInto(graph, a, b, output, workspace);
+			}
+
+			// allocates a new solution on every call, with a workspace kept per calling thread
+			traffic::Solution operator() (const traffic::Graph& graph, const traffic::Solution& a, const traffic::Solution& b) const;
+
+			explicit operator bool (void) const {
+				return static_cast<bool>(this->combineInto);
+			}
+	};
+
+}
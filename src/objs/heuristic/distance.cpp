@@ -0,0 +1,113 @@
+#include "heuristic.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+template<typename T>
+TimeUnit scalarCircularDistance (const T* a, const T* b, size_t n, TimeUnit cycle) {
+	TimeUnit totalDistance = 0;
+	for (size_t v = 0; v < n; v++) {
+		TimeUnit clockwiseDistance = abs((TimeUnit) a[v] - (TimeUnit) b[v]);
+		totalDistance += min(clockwiseDistance, cycle - clockwiseDistance);
+	}
+	return totalDistance;
+}
+
+#ifdef X86_KERNELS
+
+__attribute__((target("avx2")))
+TimeUnit horizontalSum (__m256i sums) {
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(half);
+}
+
+__attribute__((target("avx2")))
+TimeUnit avx2CircularDistance (const int32_t* a, const int32_t* b, size_t n, TimeUnit cycle) {
+	const __m256i cycles = _mm256_set1_epi32(cycle);
+	__m256i sums = _mm256_setzero_si256();
+	size_t v = 0;
+	for (; v+8 <= n; v += 8) {
+		__m256i clockwise = _mm256_abs_epi32(_mm256_sub_epi32(
+			_mm256_loadu_si256((const __m256i*) (a+v)),
+			_mm256_loadu_si256((const __m256i*) (b+v))
+		));
+		sums = _mm256_add_epi32(sums, _mm256_min_epi32(clockwise, _mm256_sub_epi32(cycles, clockwise)));
+	}
+	return horizontalSum(sums) + scalarCircularDistance(a+v, b+v, n-v, cycle);
+}
+
+__attribute__((target("avx2")))
+TimeUnit avx2CircularDistance (const uint16_t* a, const uint16_t* b, size_t n, TimeUnit cycle) {
+	// a cycle of 2^16 wraps to 0, and the 16 bit subtraction below still gives cycle-clockwise
+	const __m256i cycles = _mm256_set1_epi16(cycle);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i sums = _mm256_setzero_si256();
+	size_t v = 0;
+	for (; v+16 <= n; v += 16) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (a+v));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b+v));
+		__m256i clockwise = _mm256_sub_epi16(_mm256_max_epu16(x, y), _mm256_min_epu16(x, y));
+		__m256i distances = _mm256_min_epu16(clockwise, _mm256_sub_epi16(cycles, clockwise));
+		// distances reach 2^15, which a signed 16 bit multiply-add would read as negative, so they are zero-extended into 32 bit lanes instead
+		sums = _mm256_add_epi32(sums, _mm256_unpacklo_epi16(distances, zero));
+		sums = _mm256_add_epi32(sums, _mm256_unpackhi_epi16(distances, zero));
+	}
+	return horizontalSum(sums) + scalarCircularDistance(a+v, b+v, n-v, cycle);
+}
+
+__attribute__((target("avx2")))
+TimeUnit avx2CircularDistance (const uint8_t* a, const uint8_t* b, size_t n, TimeUnit cycle) {
+	const __m256i cycles = _mm256_set1_epi8((char) cycle);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i sums = _mm256_setzero_si256();
+	size_t v = 0;
+	for (; v+32 <= n; v += 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (a+v));
+		__m256i y = _mm256_loadu_si256((const __m256i*) (b+v));
+		__m256i clockwise = _mm256_sub_epi8(_mm256_max_epu8(x, y), _mm256_min_epu8(x, y));
+		// psadbw against zero adds each group of 8 bytes into a 64 bit lane
+		sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_min_epu8(clockwise, _mm256_sub_epi8(cycles, clockwise)), zero));
+	}
+	__m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+	half = _mm_add_epi64(half, _mm_unpackhi_epi64(half, half));
+	return (TimeUnit) _mm_cvtsi128_si64(half) + scalarCircularDistance(a+v, b+v, n-v, cycle);
+}
+
+#endif
+
+template<typename T>
+TimeUnit dispatchCircularDistance (const T* a, const T* b, size_t n, TimeUnit cycle) {
+#ifdef X86_KERNELS
+	static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+	if (hasAVX2) {
+		return avx2CircularDistance(a, b, n, cycle);
+	}
+#endif
+	return scalarCircularDistance(a, b, n, cycle);
+}
+
+TimeUnit heuristic::circularDistance (const int32_t* a, const int32_t* b, size_t n, TimeUnit cycle) {
+	return dispatchCircularDistance(a, b, n, cycle);
+}
+
+TimeUnit heuristic::circularDistance (const uint16_t* a, const uint16_t* b, size_t n, TimeUnit cycle) {
+	return dispatchCircularDistance(a, b, n, cycle);
+}
+
+TimeUnit heuristic::circularDistance (const uint8_t* a, const uint8_t* b, size_t n, TimeUnit cycle) {
+	return dispatchCircularDistance(a, b, n, cycle);
+}
+
+TimeUnit heuristic::distance(const Graph& graph, const Solution& a, const Solution& b) {
+	return circularDistance(a.data(), b.data(), a.size(), graph.getCycle());
+}
@@ -0,0 +1,94 @@
+#include "distance_cache.h"
+#include "heuristic.h"
+
+#include <random>
+#include <algorithm>
+#include <numeric>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+DistanceCache::DistanceCache (size_t numberOfIndividuals) :
+	numberOfIndividuals(numberOfIndividuals),
+	distances(new atomic<TimeUnit>[numberOfIndividuals*(numberOfIndividuals-1)/2+1])
+{
+	for (size_t i = 0; i < numberOfIndividuals*(numberOfIndividuals-1)/2+1; i++) {
+		this->distances[i].store(UNKNOWN, memory_order_relaxed);
+	}
+}
+
+size_t DistanceCache::indexOf (size_t id1, size_t id2) const {
+	if (id1 > id2) {
+		swap(id1, id2);
+	}
+	return id2*(id2-1)/2 + id1;
+}
+
+TimeUnit DistanceCache::distance (const Graph& graph, const Individual& a, const Individual& b) {
+	if (a.id == b.id) {
+		return 0;
+	}
+
+	auto& entry = this->distances[this->indexOf(a.id, b.id)];
+	auto cachedDistance = entry.load(memory_order_relaxed);
+	if (cachedDistance == UNKNOWN) {
+		cachedDistance = heuristic::distance(graph, a.solution, b.solution);
+		entry.store(cachedDistance, memory_order_relaxed);
+	}
+	return cachedDistance;
+}
+
+void DistanceCache::invalidate (size_t id) {
+	for (size_t other = 0; other < this->numberOfIndividuals; other++) {
+		if (other != id) {
+			this->distances[this->indexOf(id, other)].store(UNKNOWN, memory_order_relaxed);
+		}
+	}
+}
+
+size_t DistanceCache::size (void) const {
+	return this->numberOfIndividuals;
+}
+
+DistanceSketch::DistanceSketch (void) :
+	cycle(0),
+	scale(1)
+{}
+
+DistanceSketch::DistanceSketch (const Graph& graph, size_t sketchSize) :
+	cycle(graph.getCycle()),
+	scale(1)
+{
+	Vertex nVertices = graph.getNumberOfVertices();
+	if (sketchSize == 0 || sketchSize >= nVertices) {
+		return;
+	}
+	if (this->cycle > numeric_limits<uint16_t>::max()+1) {
+		throw invalid_argument("distance sketches require a cycle of at most 65536");
+	}
+
+	random_device seeder;
+	mt19937 randomEngine(seeder());
+	vector<Vertex> vertices(nVertices);
+	iota(vertices.begin(), vertices.end(), 0);
+
+	// sampling from a forward range keeps the vertices in order, so sketching walks the solution sequentially
+	sample(vertices.begin(), vertices.end(), back_inserter(this->sampledVertices), sketchSize, randomEngine);
+	this->scale = (double) nVertices/sketchSize;
+}
+
+bool DistanceSketch::isExact (void) const {
+	return this->sampledVertices.empty();
+}
+
+void DistanceSketch::update (Individual& individual) const {
+	individual.sketch.resize(this->sampledVertices.size());
+	for (size_t i = 0; i < this->sampledVertices.size(); i++) {
+		individual.sketch[i] = individual.solution[this->sampledVertices[i]];
+	}
+}
+
+TimeUnit DistanceSketch::estimatedDistance (const Individual& a, const Individual& b) const {
+	return circularDistance(a.sketch.data(), b.sketch.data(), this->sampledVertices.size(), this->cycle)*this->scale + 0.5;
+}
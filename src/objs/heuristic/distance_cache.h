@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include "population.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace heuristic {
+
+	/*
+	 * Pairwise distances between the individuals of a population, keyed by Individual::id, which must lie in [0, numberOfIndividuals).
+	 * A distance is computed the first time it is asked for and kept until one of its individuals is given a new solution,
+	 * which must be signaled with invalidate. Entries are atomic so that threads working on disjoint pairs can share the cache
+	 */
+	class DistanceCache {
+		private:
+			size_t numberOfIndividuals;
+			// upper triangle of the distance matrix, UNKNOWN where not yet computed
+			std::unique_ptr<std::atomic<traffic::TimeUnit>[]> distances;
+
+			size_t indexOf (size_t id1, size_t id2) const;
+		public:
+			static constexpr traffic::TimeUnit UNKNOWN = -1;
+
+			DistanceCache (size_t numberOfIndividuals);
+
+			traffic::TimeUnit distance (const traffic::Graph& graph, const Individual& a, const Individual& b);
+			void invalidate (size_t id);
+
+			size_t size (void) const;
+	};
+
+	/*
+	 * Approximates the distance between two solutions from their timings at a fixed random sample of sketchSize vertices, scaled up to the whole graph.
+	 * A sketchSize of 0, or one covering every vertex, keeps distances exact. Sketches are 16 bit, so cycles above 2^16 can only use exact distances
+	 */
+	class DistanceSketch {
+		private:
+			std::vector<traffic::Vertex> sampledVertices;
+			traffic::TimeUnit cycle;
+			double scale;
+		public:
+			// relative difference between two estimates below which they are told apart with exact distances
+			static constexpr double CLOSE_CALL_TOLERANCE = 0.1;
+
+			DistanceSketch (void);
+			DistanceSketch (const traffic::Graph& graph, size_t sketchSize);
+
+			bool isExact (void) const;
+			// must be called whenever the solution of the individual changes
+			void update (Individual& individual) const;
+			traffic::TimeUnit estimatedDistance (const Individual& a, const Individual& b) const;
+	};
+
+}
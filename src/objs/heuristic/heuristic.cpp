@@ -1,4 +1,5 @@
 #include "heuristic.h"
+#include "../rng/random_stream.h"
 
 #include <random>
 #include <algorithm>
@@ -10,13 +11,11 @@ using namespace std;
 
 Solution heuristic::constructRandomSolution (const Graph& graph) {
 
-	random_device seeder;
-	mt19937 randomEngine(seeder());
-	uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
+	rng::bounded_stream timingPicker(graph.getCycle());
 	Solution solution(graph.getNumberOfVertices());
 
 	for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
-		solution[v] = timingPicker(randomEngine);
+		solution[v] = timingPicker();
 	}
 
 	return solution;
@@ -33,7 +32,7 @@ Solution heuristic::constructHeuristicSolution (const Graph& graph, Vertex numbe
 	random_device seeder;
 	mt19937 randomEngine(seeder());
 	uniform_int_distribution<Vertex> edgePicker;
-	uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
+	rng::bounded_stream timingPicker(graph.getCycle());
 	TimeUnit infinite = numeric_limits<TimeUnit>::max();
 	TimeUnit candidateTimingVertex1, candidateTimingVertex2, penalty;
 	Solution solution(graph.getNumberOfVertices());
@@ -56,7 +55,7 @@ Solution heuristic::constructHeuristicSolution (const Graph& graph, Vertex numbe
 		vertex2 = neighborhoodIterator->first;
 
 		for (decltype(numberOfTuplesToTestPerIteration) i = 0; i < 2*numberOfTuplesToTestPerIteration; i++) {
-			candidateTimings[i] = timingPicker(randomEngine);
+			candidateTimings[i] = timingPicker();
 		}
 
 		bestPenalty = infinite;
@@ -85,184 +84,237 @@ Solution heuristic::constructHeuristicSolution (const Graph& graph, Vertex numbe
 	return solution;
 }
 
-TimeUnit heuristic::distance(const Graph& graph, const Solution& a, const Solution& b) {
-	auto cycle = graph.getCycle();
-	TimeUnit totalDistance = 0;
-	for (Vertex v = 0; v < a.size(); v++) {
-		auto clockwiseDistance = abs(a[v] - b[v]);
-		auto counterClockwiseDistance = cycle - clockwiseDistance;
-		totalDistance += min(clockwiseDistance, counterClockwiseDistance);
+Solution heuristic::constructGreedySolution (const Graph& graph) {
+	Vertex nVertices = graph.getNumberOfVertices();
+	vector<Vertex> roots(nVertices);
+	vector<bool> isAssigned(nVertices, false);
+	vector<bool> wasVisited(nVertices, false);
+	queue<Vertex> visitQueue;
+	Vertex vertex;
+	random_device seeder;
+	mt19937 randomEngine(seeder());
+	rng::bounded_stream timingPicker(graph.getCycle());
+	Solution solution(nVertices);
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		roots[v] = v;
 	}
+	shuffle(roots.begin(), roots.end(), randomEngine);
 
-	return totalDistance;
-}
+	// every connected component is traversed from a random root, which keeps a random timing
+	for (auto root : roots) {
+		if (wasVisited[root]) {
+			continue;
+		}
 
-struct Perturbation {
-	TimeUnit timing;
-	TimeUnit penalty;
-};
+		solution[root] = timingPicker();
+		isAssigned[root] = true;
+		wasVisited[root] = true;
+		visitQueue.push(root);
 
-Solution heuristic::localSearchHeuristic(const Graph& graph, const Solution& initialSolution, const StopFunction &stopCriteriaNotMet) {
-	Solution solution(initialSolution);
-	TimeUnit currentTiming, currentPenalty;
-	TimeUnit perturbationTiming, perturbationPenalty;
-	Vertex vertex;
-	bool iterationHadNoImprovement;
-	Metrics metrics;
+		while (!visitQueue.empty()) {
+			vertex = visitQueue.front();
+			visitQueue.pop();
 
-	random_device seeder;
-	mt19937 randomEngine(seeder());
-	uniform_int_distribution<Vertex> vertexPicker(0, graph.getNumberOfVertices()-1);
-	uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
+			if (!isAssigned[vertex]) {
+				solution[vertex] = optimalTiming(graph, vertex, solution, isAssigned).timing;
+				isAssigned[vertex] = true;
+			}
 
-	metrics.numberOfIterations = 0;
-	metrics.numberOfIterationsWithoutImprovement = 0;
-	metrics.executionBegin = chrono::high_resolution_clock::now();
-	while (stopCriteriaNotMet(metrics)) {
-		iterationHadNoImprovement = true;
+			for (auto& neighbor : graph.neighborsOf(vertex)) {
+				if (!wasVisited[neighbor.first]) {
+					wasVisited[neighbor.first] = true;
+					visitQueue.push(neighbor.first);
+				}
+			}
+		}
+	}
 
-		vertex = vertexPicker(randomEngine);
+	return solution;
+}
 
-		currentTiming = solution[vertex];
-		currentPenalty = graph.vertexPenalty(vertex, solution);
-		perturbationTiming = timingPicker(randomEngine);
-		solution[vertex] = perturbationTiming;
-		perturbationPenalty = graph.vertexPenalty(vertex, solution);
+Solution heuristic::constructSpanningTreeSolution (const Graph& graph) {
+	Vertex nVertices = graph.getNumberOfVertices();
+	vector<Vertex> roots(nVertices);
+	vector<bool> wasVisited(nVertices, false);
+	vector<Vertex> frontier;
+	Vertex vertex;
+	TimeUnit cycle = graph.getCycle();
+	random_device seeder;
+	mt19937 randomEngine(seeder());
+	rng::bounded_stream timingPicker(cycle);
+	rng::bounded_stream signPicker(2);
+	Solution solution(nVertices);
 
-		if (perturbationPenalty < currentPenalty) {
-			iterationHadNoImprovement = false;
-		} else {
-			solution[vertex] = currentTiming;
+	for (Vertex v = 0; v < nVertices; v++) {
+		roots[v] = v;
+	}
+	shuffle(roots.begin(), roots.end(), randomEngine);
+
+	frontier.reserve(nVertices);
+	for (auto root : roots) {
+		if (wasVisited[root]) {
+			continue;
 		}
 
-		metrics.numberOfIterations++;
-		if (iterationHadNoImprovement) {
-			metrics.numberOfIterationsWithoutImprovement++;
-		} else {
-			metrics.numberOfIterationsWithoutImprovement = 0;
+		solution[root] = timingPicker();
+		wasVisited[root] = true;
+		frontier.push_back(root);
+
+		// expanding a random frontier vertex instead of the oldest one gives a different spanning tree on every call
+		while (!frontier.empty()) {
+			swap(frontier[uniform_int_distribution<size_t>(0, frontier.size()-1)(randomEngine)], frontier.back());
+			vertex = frontier.back();
+			frontier.pop_back();
+
+			for (auto& neighbor : graph.neighborsOf(vertex)) {
+				if (!wasVisited[neighbor.first]) {
+					TimeUnit weight = neighbor.second%cycle;
+					// both t_u + w and t_u - w give the tree edge its minimum penalty, so the side is also picked at random
+					solution[neighbor.first] = signPicker() ? (solution[vertex] + weight)%cycle : (solution[vertex] - weight + cycle)%cycle;
+					wasVisited[neighbor.first] = true;
+					frontier.push_back(neighbor.first);
+				}
+			}
 		}
 	}
+
 	return solution;
 }
 
-StopFunction stop_function_factory::penalty(TimeUnit penalty) {
-	return [=](const Metrics& metrics) {
-		return metrics.penalty > penalty;
+ConstructionMethod construction_method_factory::randomSolution (void) {
+	return [](const Graph& graph) -> Solution {
+		return constructRandomSolution(graph);
 	};
 }
 
-StopFunction stop_function_factory::numberOfIterations(unsigned numberOfIterationsToStop) {
-	return [=](const Metrics& metrics) -> bool {
-		return metrics.numberOfIterations < numberOfIterationsToStop;
+ConstructionMethod construction_method_factory::heuristicSolution (Vertex numberOfTuplesToTestPerIteration) {
+	return [=](const Graph& graph) -> Solution {
+		return constructHeuristicSolution(graph, numberOfTuplesToTestPerIteration);
 	};
 }
 
-StopFunction stop_function_factory::numberOfIterationsWithoutImprovement(unsigned numberOfIterationsToStop) {
-	return [=](const Metrics& metrics) -> bool {
-		return metrics.numberOfIterationsWithoutImprovement < numberOfIterationsToStop;
+ConstructionMethod construction_method_factory::greedySolution (void) {
+	return [](const Graph& graph) -> Solution {
+		return constructGreedySolution(graph);
 	};
 }
 
-CombinationMethod combination_method_factory::breadthFirstSearch (double mutationProbability) {
-	return [mutationProbability](const Graph& graph, const Solution &s1, const Solution &s2) -> Solution {
-		random_device seeder;
-		mt19937 randomEngine(seeder());
-		uniform_int_distribution<Vertex> vertexPicker(0, graph.getNumberOfVertices()-1);
-		uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
-		uniform_real_distribution<decltype(mutationProbability)> mutationPicker(0.0, 1.0);
-		Vertex v = vertexPicker(randomEngine);
-		unsigned i = 0, middle;
-		size_t nVertices = graph.getNumberOfVertices();
-		bool *visited = new bool[nVertices]{false};
-		Solution solution(nVertices);
-		queue<Vertex> q;
-		q.push(v);
-
-		middle = nVertices % 2 ? (nVertices / 2) + 1 : nVertices / 2;
-
-		visited[v] = true;
-
-		while(!q.empty())
-		{
-			v = q.front();
-			q.pop();
+ConstructionMethod construction_method_factory::spanningTreeSolution (void) {
+	return [](const Graph& graph) -> Solution {
+		return constructSpanningTreeSolution(graph);
+	};
+}
 
-			for(auto u : graph.neighborsOf(v))
-			{
-				if(!visited[u.first])
-				{
-					visited[u.first] = true;
-					q.push(u.first);
-				}
-			}
+void heuristic::localSearchInPlace(const Graph& graph, Solution& solution, const StopFunction &stopCriteriaNotMet) {
+	// recover the concrete policy so the per iteration check is inlined, falling back to the type-erased function otherwise
+	if (auto policy = stopCriteriaNotMet.target<stop_policy::NumberOfIterations>()) {
+		localSearchInPlace(graph, solution, *policy);
+	} else if (auto policy = stopCriteriaNotMet.target<stop_policy::NumberOfIterationsWithoutImprovement>()) {
+		localSearchInPlace(graph, solution, *policy);
+	} else if (auto policy = stopCriteriaNotMet.target<stop_policy::ExecutionTime>()) {
+		localSearchInPlace(graph, solution, stop_policy::Amortized<stop_policy::ExecutionTime>(*policy));
+	} else if (auto policy = stopCriteriaNotMet.target<stop_policy::Cancellable<stop_policy::NumberOfIterations>>()) {
+		localSearchInPlace(graph, solution, *policy);
+	} else {
+		localSearchInPlace(graph, solution, cref(stopCriteriaNotMet));
+	}
+}
 
-			if(i < middle)
-			{
-				solution[v] = s1[v];
-			}
-			else
-			{
-				solution[v] = s2[v];
-			}
+Solution heuristic::localSearchHeuristic(const Graph& graph, const Solution& initialSolution, const StopFunction &stopCriteriaNotMet) {
+	Solution solution(initialSolution);
+	localSearchInPlace(graph, solution, stopCriteriaNotMet);
+	return solution;
+}
 
-			i++;
-		}
+StopFunction stop_function_factory::penalty(TimeUnit penalty) {
+	return stop_policy::Penalty{penalty};
+}
 
-		if (mutationPicker(randomEngine) <= mutationProbability) {
-			auto vertex = vertexPicker(randomEngine);
-			auto timing = timingPicker(randomEngine);
-			solution[vertex] = timing;
-		}
+StopFunction stop_function_factory::numberOfIterations(unsigned numberOfIterationsToStop) {
+	return stop_policy::NumberOfIterations{numberOfIterationsToStop};
+}
+
+StopFunction stop_function_factory::numberOfIterationsWithoutImprovement(unsigned numberOfIterationsToStop) {
+	return stop_policy::NumberOfIterationsWithoutImprovement{numberOfIterationsToStop};
+}
+
+StopFunction stop_function_factory::cancellable(const StopFunction& stopFunction, const atomic<bool>& cancelled) {
+	// local searches recognize this one and inline it
+	if (auto policy = stopFunction.target<stop_policy::NumberOfIterations>()) {
+		return stop_policy::Cancellable<stop_policy::NumberOfIterations>{*policy, &cancelled};
+	}
+	return stop_policy::Cancellable<StopFunction>{stopFunction, &cancelled};
+}
+
+ImprovementMethod improvement_method_factory::localSearch (void) {
+	return [](const Graph& graph, Solution& solution, const StopFunction& stopFunction) {
+		localSearchInPlace(graph, solution, stopFunction);
+	};
+}
+
+ImprovementMethod improvement_method_factory::tabuSearch (unsigned tabuTenure, unsigned numberOfCandidateVertices) {
+	return [=](const Graph& graph, Solution& solution, const StopFunction& stopFunction) {
+		tabuSearchInPlace(graph, solution, stopFunction, tabuTenure, numberOfCandidateVertices);
+	};
+}
+
+ImprovementMethod improvement_method_factory::cancellable (const ImprovementMethod& improvementMethod, const atomic<bool>& cancelled) {
+	return [improvementMethod, &cancelled](const Graph& graph, Solution& solution, const StopFunction& stopFunction) {
+		improvementMethod.improve(graph, solution, stop_function_factory::cancellable(stopFunction, cancelled));
+	};
+}
 
-		delete [] visited;
-		return solution;
+ImprovementMethod improvement_method_factory::activeVertexLocalSearch (void) {
+	return [](const Graph& graph, Solution& solution, const StopFunction&) {
+		activeVertexLocalSearchInPlace(graph, solution);
 	};
 }
 
 CombinationMethod combination_method_factory::crossover (double mutationProbability) {
-	return [=](const Graph& graph, const Solution &a, const Solution &b) -> Solution {
+	return [=](const Graph& graph, const Solution &a, const Solution &b, Solution &solution, CombinationWorkspace &workspace) {
 
 		Vertex nVertices = graph.getNumberOfVertices();
 		Vertex pRange = nVertices / 2;
 
-		random_device seeder;
-		mt19937 randomEngine(seeder());
 		uniform_int_distribution<int> pPicker(-pRange, pRange);
-		uniform_real_distribution<double> mutPicker(0.0, 1.0);
-		uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
+		rng::uniform_stream mutPicker;
+		rng::bounded_stream timingPicker(graph.getCycle());
 
-		Solution solution(nVertices);
+		solution.resize(nVertices);
 
-		int p = pPicker(randomEngine);
+		int p = pPicker(workspace.randomEngine);
 		Vertex k = nVertices / 2 + p;
 
 		for(Vertex v = 0; v < nVertices; v++)
 		{
 			solution[v] = v <= k ? a[v] : b[v];
 
-			if(mutPicker(randomEngine) <= mutationProbability)
+			if(mutPicker() <= mutationProbability)
 			{
-				solution[v] = timingPicker(randomEngine);
+				solution[v] = timingPicker();
 			}
 		}
-
-		return solution;
 	};
 }
 
-Solution heuristic::geneticAlgorithm(const Graph& graph, size_t populationSize, const StopFunction &stopFunction, const CombinationMethod &combinationMethod) {
+Solution heuristic::geneticAlgorithm(const Graph& graph, size_t populationSize, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfInitializationThreads) {
 	if(populationSize < 2)
 	{
 		throw invalid_argument("populationSize must be >= 2");
 	}
 
-	Solution bestSolution(graph.getNumberOfVertices()), aux;
+	Solution bestSolution(graph.getNumberOfVertices());
 	TimeUnit lowestPenalty = numeric_limits<TimeUnit>::max();
 	random_device seeder;
 	mt19937 randomEngine(seeder());
 	uniform_int_distribution<size_t> tournamentPicker;
-	vector<pair<Solution, TimeUnit>> population, parents;
-	pair<Solution, TimeUnit> tournamentWinner, tournamentIndividual;
+	// the first populationSize individuals are the population, the rest are slots whose solutions are reused by the children of each iteration
+	vector<Individual> population;
+	vector<size_t> parents;
+	CombinationWorkspace workspace(randomEngine());
+	SolutionHasher solutionHasher;
+	SolutionHashSet populationHashes;
 	unsigned replaceSize = populationSize * 1.0, tournamentSize = 0.4 * populationSize;
 
 	Metrics metrics;
@@ -279,38 +331,47 @@ Solution heuristic::geneticAlgorithm(const Graph& graph, size_t populationSize,
 	}
 
 	population.reserve(populationSize + replaceSize);
+	populationHashes.reserve(populationSize + replaceSize);
 	parents.reserve(replaceSize);
 	tournamentPicker.param(std::uniform_int_distribution<size_t>::param_type(0, populationSize - 1));
 
 	metrics.executionBegin = chrono::high_resolution_clock::now();
+
+	// the initial population is only constructed, not improved, so the local search is given no iterations
+	Population<Individual> initialPopulation(populationSize);
+	parallel::initializePopulation(graph, {
+		{initialPopulation.slice(0, populationSize), stop_function_factory::numberOfIterations(0), construction_method_factory::heuristicSolution()}
+	}, numberOfInitializationThreads, improvement_method_factory::localSearch());
+
 	for(size_t i = 0; i < populationSize; i++)
 	{
-		aux = constructHeuristicSolution(graph);
-		population.push_back(make_pair(aux, graph.totalPenalty(aux)));
+		initialPopulation[i].hash = solutionHasher.hash(initialPopulation[i].solution);
+		population.push_back(move(initialPopulation[i]));
 
-		if(population[i].second < lowestPenalty)
+		if(population[i].penalty < lowestPenalty)
 		{
-			bestSolution = population[i].first;
-			lowestPenalty = population[i].second;
+			bestSolution = population[i].solution;
+			lowestPenalty = population[i].penalty;
 		}
 	}
+	population.resize(populationSize + replaceSize);
 
 	metrics.numberOfIterations = 0;
 	metrics.numberOfIterationsWithoutImprovement = 0;
+	metrics.penalty = lowestPenalty;
+	metrics.solution = &bestSolution;
 	while(stopFunction(metrics))
 	{
 		iterationHadNoImprovement = true;
 		for(unsigned selectedParents = 0; selectedParents < replaceSize; selectedParents++)
 		{
-			size_t random = tournamentPicker(randomEngine);
-			tournamentWinner = population[random];
+			size_t tournamentWinner = tournamentPicker(randomEngine);
 
 			for(unsigned j = 0; j < tournamentSize - 1; j++)
 			{
-				random = tournamentPicker(randomEngine);
-				tournamentIndividual = population[random];
+				size_t tournamentIndividual = tournamentPicker(randomEngine);
 
-				if(tournamentIndividual.second < tournamentWinner.second)
+				if(population[tournamentIndividual].penalty < population[tournamentWinner].penalty)
 				{
 					tournamentWinner = tournamentIndividual;
 				}
@@ -319,26 +380,38 @@ Solution heuristic::geneticAlgorithm(const Graph& graph, size_t populationSize,
 			parents.push_back(tournamentWinner);
 		}
 
-		std::sort(parents.begin(), parents.end(), [](auto &a, auto &b) {
-    		return a.second < b.second;
+		std::sort(parents.begin(), parents.end(), [&](auto a, auto b) {
+    		return population[a].penalty < population[b].penalty;
 		});
 
+		populationHashes.clear();
+		for(size_t i = 0; i < populationSize; i++)
+		{
+			populationHashes.insert(population[i].hash);
+		}
+
 		for(size_t j = 0; j < replaceSize; j++)
 		{
-			aux = combinationMethod(graph, parents[j].first, parents[(j+1) % replaceSize].first);
-			population.push_back(make_pair(aux, graph.totalPenalty(aux)));
+			auto& child = population[populationSize + j];
+			combinationMethod(graph, population[parents[j]].solution, population[parents[(j+1) % replaceSize]].solution, child.solution, workspace);
+			// children identical to a member of the population, or to an earlier sibling, are mutated before being evaluated
+			child.hash = solutionHasher.mutateUntilUnique(graph, child.solution, solutionHasher.hash(child.solution), populationHashes, randomEngine);
+			child.penalty = graph.totalPenalty(child.solution);
+			populationHashes.insert(child.hash);
 		}
 
 		std::sort(population.begin(), population.end(), [](auto &a, auto &b) {
-    		return a.second < b.second;
+    		return a.penalty < b.penalty;
 		});
 
-		population.erase(population.end() - 1 - replaceSize, population.end() - 1);
+		// the best populationSize-1 individuals survive along with the worst one, the others become child slots
+		swap(population[populationSize - 1], population.back());
 
-		if(population[0].second < lowestPenalty)
+		if(population[0].penalty < lowestPenalty)
 		{
-			lowestPenalty = population[0].second;
-			bestSolution = population[0].first;
+			lowestPenalty = population[0].penalty;
+			bestSolution = population[0].solution;
+			metrics.penalty = lowestPenalty;
 			iterationHadNoImprovement = false;
 		}
 
@@ -4,53 +4,243 @@
 #include <unordered_set>
 #include <functional>
 #include <chrono>
+#include <cstdint>
+#include <memory>
 #include "population.h"
+#include "distance_cache.h"
+#include "solution_hash.h"
+#include "combination_method.h"
+#include "improvement_method.h"
+#include "migration_transport.h"
+#include "stop_policy.h"
+#include "local_search.h"
 
 namespace heuristic {
 	traffic::Solution constructRandomSolution (const traffic::Graph& graph);
 	traffic::Solution constructHeuristicSolution (const traffic::Graph& graph, traffic::Vertex numberOfTuplesToTestPerIteration=3);
+	// visits vertices in breadth-first order from random roots, giving each the optimal timing against its already visited neighbors
+	traffic::Solution constructGreedySolution (const traffic::Graph& graph);
+	// gives every edge of a random spanning tree its minimum penalty by setting t_v = t_u +- w along the tree, in O(V+E)
+	traffic::Solution constructSpanningTreeSolution (const traffic::Graph& graph);
+
+	typedef std::function<traffic::Solution(const traffic::Graph&)> ConstructionMethod;
+
+	namespace construction_method_factory {
+		ConstructionMethod randomSolution(void);
+		ConstructionMethod heuristicSolution(traffic::Vertex numberOfTuplesToTestPerIteration=3);
+		ConstructionMethod greedySolution(void);
+		ConstructionMethod spanningTreeSolution(void);
+	}
 
 	traffic::TimeUnit distance(const traffic::Graph& graph, const traffic::Solution& a, const traffic::Solution& b);
 
-	struct Metrics {
+	/*
+	 * Sum of the circular distances between two arrays of n timings in [0, cycle). Each width has an AVX2 kernel, chosen at run time
+	 * when the processor supports it, and a scalar fallback. The 16 bit version requires cycle <= 2^16 and the 8 bit one cycle <= 2^8,
+	 * the latter reducing with psadbw
+	 */
+	traffic::TimeUnit circularDistance (const int32_t* a, const int32_t* b, size_t n, traffic::TimeUnit cycle);
+	traffic::TimeUnit circularDistance (const uint16_t* a, const uint16_t* b, size_t n, traffic::TimeUnit cycle);
+	traffic::TimeUnit circularDistance (const uint8_t* a, const uint8_t* b, size_t n, traffic::TimeUnit cycle);
+
+	struct Perturbation {
+		traffic::TimeUnit timing;
 		traffic::TimeUnit penalty;
-		unsigned numberOfIterations;
-		unsigned numberOfIterationsWithoutImprovement;
-		std::chrono::high_resolution_clock::time_point executionBegin;
 	};
 
-	typedef std::function<bool(const Metrics&)> StopFunction;
+	// timing in [0, cycle) that minimizes the sum of circular distances to the given anchors, which must all lie in [0, cycle) and are sorted in place
+	Perturbation optimalTimingAmongAnchors (std::vector<traffic::TimeUnit>& anchors, traffic::TimeUnit cycle, traffic::TimeUnit currentTiming);
+	// timing which minimizes the penalty of vertex given the timings of its neighbors, found in O(degree*log(degree))
+	Perturbation optimalTiming (const traffic::Graph& graph, traffic::Vertex vertex, const traffic::Solution& solution);
+	// same as above but only considering neighbors u for which isAssigned[u] is true
+	Perturbation optimalTiming (const traffic::Graph& graph, traffic::Vertex vertex, const traffic::Solution& solution, const std::vector<bool>& isAssigned);
 
 	namespace stop_function_factory {
 
 		StopFunction numberOfIterations (unsigned numberOfIterationsToStop);
 		StopFunction numberOfIterationsWithoutImprovement (unsigned numberOfIterationsToStop);
 		StopFunction penalty(traffic::TimeUnit penalty);
+		// stops once cancelled is set, which must outlive the returned function
+		StopFunction cancellable(const StopFunction& stopFunction, const std::atomic<bool>& cancelled);
 
 		template<typename Rep, typename Period=std::ratio<1>>
 		StopFunction executionTime(const std::chrono::duration<Rep, Period>& time) {
 			std::chrono::high_resolution_clock::duration highResolutionTime = std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(time);
 
-			return [=](const Metrics &metrics) -> bool {
-				return std::chrono::high_resolution_clock::now() - metrics.executionBegin < highResolutionTime;
-			};
+			return stop_policy::ExecutionTime{highResolutionTime};
 		}
 
 	};
 
-	typedef std::function<traffic::Solution(const traffic::Graph&, const traffic::Solution&, const traffic::Solution&)> CombinationMethod;
+	// greedy walk from the initiating solution toward the guiding one, returning the best solution strictly between them
+	traffic::Solution pathRelinking(const traffic::Graph& graph, const traffic::Solution& initiatingSolution, const traffic::Solution& guidingSolution);
+
+	/*
+	 * Breadth-first orders from random roots, computed once per graph on numberOfThreads threads. Each order is kept as the side every vertex falls on:
+	 * the first half of the vertices in visiting order take their timing from the first parent, the rest from the second, and unreached vertices from neither
+	 */
+	class BreadthFirstSearchOrders {
+		public:
+			enum Side : uint8_t { FIRST, SECOND, UNREACHED };
+		private:
+			const traffic::Graph* graph;
+			traffic::Vertex numberOfVertices;
+			size_t numberOfOrders;
+			std::vector<Side> sides;
+		public:
+			BreadthFirstSearchOrders (const traffic::Graph& graph, size_t numberOfOrders, unsigned numberOfThreads=1);
+
+			inline bool isOrderOf (const traffic::Graph& graph) const {
+				return &graph == this->graph && graph.getNumberOfVertices() == this->numberOfVertices;
+			}
+
+			inline size_t size (void) const {
+				return this->numberOfOrders;
+			}
+
+			// side of every vertex under the given order, indexed by vertex
+			inline const Side* sidesOf (size_t order) const {
+				return this->sides.data() + order*this->numberOfVertices;
+			}
+	};
 
 	namespace combination_method_factory{
 		CombinationMethod breadthFirstSearch(double mutationProbability);
+		// combines with one of the precomputed orders at random, which turns the traversal into a linear pass over its sides
+		CombinationMethod breadthFirstSearch(double mutationProbability, std::shared_ptr<const BreadthFirstSearchOrders> orders);
 		CombinationMethod crossover(double mutationProbability);
+		/*
+		 * Keeps the best of numberOfPaths relinking paths: greedy walks from each parent toward the other, then walks in random order.
+		 * With more than one thread the paths are explored concurrently on a thread pile owned by the returned method.
+		 * The walks reuse the workspace buffers, so only handing the paths to that pile allocates on every call
+		 */
+		CombinationMethod pathRelinking(unsigned numberOfPaths=1, unsigned numberOfThreads=1);
 	}
 
 	traffic::Solution localSearchHeuristic(const traffic::Graph& graph, const traffic::Solution& initialSolution, const std::function<bool(const Metrics&)>& stopCriteriaNotMet);
-	traffic::Solution geneticAlgorithm(const traffic::Graph& graph, size_t populationSize, const StopFunction &stopFunction, const CombinationMethod &combinationMethod);
+	traffic::Solution activeVertexLocalSearch(const traffic::Graph& graph, const traffic::Solution& initialSolution);
+	// the in-place searches improve solution itself, with any scratch memory kept per thread, so they allocate nothing once it has grown to the graph
+	void localSearchInPlace(const traffic::Graph& graph, traffic::Solution& solution, const std::function<bool(const Metrics&)>& stopCriteriaNotMet);
+	void activeVertexLocalSearchInPlace(const traffic::Graph& graph, traffic::Solution& solution);
+	traffic::Solution activeVertexLocalSearch(const traffic::Graph& graph, const traffic::Solution& initialSolution, const StopFunction& stopCriteriaNotMet);
+	// only the given vertices start in the queue, so the search stays local to them unless their moves propagate
+	traffic::Solution activeVertexLocalSearch(const traffic::Graph& graph, const traffic::Solution& initialSolution, const std::vector<traffic::Vertex>& initiallyActiveVertices);
+	traffic::Solution tabuSearchHeuristic(const traffic::Graph& graph, const traffic::Solution& initialSolution, const StopFunction& stopCriteriaNotMet, unsigned tabuTenure=10, unsigned numberOfCandidateVertices=4);
+	void tabuSearchInPlace(const traffic::Graph& graph, traffic::Solution& solution, const StopFunction& stopCriteriaNotMet, unsigned tabuTenure=10, unsigned numberOfCandidateVertices=4);
+
+	namespace improvement_method_factory {
+		ImprovementMethod localSearch(void);
+		// runs until no vertex can be improved, ignoring the stop function given by the caller
+		ImprovementMethod activeVertexLocalSearch(void);
+		ImprovementMethod tabuSearch(unsigned tabuTenure, unsigned numberOfCandidateVertices);
+		// passes improvementMethod stop functions that also stop once cancelled is set, which must outlive the returned method
+		ImprovementMethod cancellable(const ImprovementMethod& improvementMethod, const std::atomic<bool>& cancelled);
+	}
+
+	// only the construction of the initial population runs on numberOfInitializationThreads, the generations are sequential
+	traffic::Solution geneticAlgorithm(const traffic::Graph& graph, size_t populationSize, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfInitializationThreads=1);
+
+	/*
+	 * Multilevel V-cycle: the graph is coarsened by merging matched vertices, with the timing of one fixed relative to the other,
+	 * until at most coarsestNumberOfVertices remain, or earlier once a matching removes less than a tenth of the vertices, as on star-like graphs
+	 * where most vertices have no unmatched neighbor left, so the coarsest graph may be larger than requested. The coarsest graph is solved by coarsestLevelMethod and its solution is projected back
+	 * one level at a time. Since coarse edge weights only approximate the penalties of the edges they merge, each level is refined by moving
+	 * whole clusters of original vertices, evaluated on the edges of the original graph, until no cluster can be improved
+	 */
+	traffic::Solution multilevelSearch (const traffic::Graph& graph, traffic::Vertex coarsestNumberOfVertices, const ConstructionMethod &coarsestLevelMethod);
 
 	traffic::TimeUnit diversify (const traffic::Graph &graph, ScatterSearchPopulation<Individual> &population);
-	traffic::Solution scatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod);
+	// same as above but distances between individuals already compared in previous iterations are taken from the cache
+	traffic::TimeUnit diversify (const traffic::Graph &graph, ScatterSearchPopulation<Individual> &population, DistanceCache &distanceCache);
+	// selects on sketched distances, comparing exactly only the battling individuals whose estimate is a close call with the farthest one
+	traffic::TimeUnit diversify (const traffic::Graph &graph, ScatterSearchPopulation<Individual> &population, DistanceCache &distanceCache, const DistanceSketch &distanceSketch);
+	// exact distance to the nearest selected individual, measured against the one nearest by sketched distance and those whose sketched distance is close to it
+	traffic::TimeUnit refineMinimumDistance (const traffic::Graph &graph, const Individual &individual, std::vector<Individual>::iterator selectedBegin, std::vector<Individual>::iterator selectedEnd, DistanceCache &distanceCache, const DistanceSketch &distanceSketch);
+	// only the construction of the initial population runs on numberOfInitializationThreads, the search itself is sequential
+	traffic::Solution scatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, const ImprovementMethod &improvementMethod=improvement_method_factory::localSearch(), const ConstructionMethod &constructionMethod=construction_method_factory::heuristicSolution(), const ConstructionMethod &diverseConstructionMethod=construction_method_factory::heuristicSolution(), size_t sketchSize=0, unsigned numberOfInitializationThreads=1);
 	namespace parallel {
-		traffic::Solution scatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads);
+		struct PopulationInitialization {
+			PopulationSlice<Individual> individuals;
+			StopFunction localSearchStopFunction;
+			ConstructionMethod constructionMethod;
+		};
+
+		/*
+		 * Fills every individual with the construction method of its slice followed by improvementMethod under the stop function of its slice.
+		 * Individuals are handed to threads one at a time in the order given, so slices with the longest searches should come first
+		 */
+		void initializePopulation (const traffic::Graph& graph, const std::vector<PopulationInitialization> &slices, unsigned numberOfThreads, const ImprovementMethod &improvementMethod);
+
+		/*
+		 * How the sub-populations of the threads exchange individuals. TREE stops every thread and merges what they discard bottom-up,
+		 * pairing halves of the threads at each level. The other topologies never stop the search: a thread that is due posts copies of its
+		 * best elite and most isolated diverse individuals to one neighbor's mailbox, and takes in its own mailbox after every iteration.
+		 * RING sends to the next thread, HYPERCUBE to the partner across one dimension at a time and RANDOM_PAIRS to a random thread.
+		 * An exchange is due every interval iterations, or once the best penalty stagnated for stagnation iterations; 0 disables either trigger
+		 */
+		struct MigrationPolicy {
+			enum Topology { TREE, RING, HYPERCUBE, RANDOM_PAIRS };
+
+			Topology topology = TREE;
+			unsigned interval = 1;
+			unsigned stagnation = 0;
+			// number of elite and of diverse individuals sent by each exchange, TREE exchanges whole discarded sets instead
+			size_t numberOfMigrants = 2;
+
+			inline bool isDue (size_t iterationsSinceMigration, size_t iterationsWithoutImprovement) const {
+				return (this->interval > 0 && iterationsSinceMigration >= this->interval) ||
+					(this->stagnation > 0 && iterationsWithoutImprovement >= this->stagnation && iterationsSinceMigration >= this->stagnation);
+			}
+		};
+
+		/*
+		 * Where the threads of a search run and where their memory lives on machines with several NUMA nodes. With pinThreads every thread stays
+		 * on one cpu, neighboring threads sharing a node, and rewrites its sub-population once it is initialized so the pages are first touched,
+		 * and so allocated, on its own node. With replicateGraph each node also gets its own copy of the graph for local searches and penalties,
+		 * while combinations keep the original one, since combination methods may hold precomputations tied to it
+		 */
+		struct NumaPlacement {
+			bool pinThreads = false;
+			bool replicateGraph = false;
+		};
+
+		traffic::Solution scatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const ImprovementMethod &improvementMethod=improvement_method_factory::localSearch(), const ConstructionMethod &constructionMethod=construction_method_factory::heuristicSolution(), const ConstructionMethod &diverseConstructionMethod=construction_method_factory::heuristicSolution(), size_t sketchSize=0, const MigrationPolicy &migrationPolicy=MigrationPolicy(), const NumaPlacement &numaPlacement=NumaPlacement());
+
+		struct IslandMigration {
+			std::shared_ptr<MigrationTransport> transport;
+			// iterations between two migrations
+			unsigned interval;
+			// number of elite and of diverse individuals sent on each migration
+			size_t numberOfMigrants;
+		};
+
+		/*
+		 * Island model: the parallel scatter search above, exchanging individuals with other islands every migration.interval iterations.
+		 * It sends its best elite individuals and its most isolated diverse ones, then takes in the migrants received so far, best first,
+		 * as many as there are candidate slots. They compete for the reference sets like the individuals discarded by other threads do.
+		 * Under the asynchronous topologies of migrationPolicy only the sub-population of the first thread meets other islands
+		 */
+		traffic::Solution islandScatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const IslandMigration &migration, const ImprovementMethod &improvementMethod=improvement_method_factory::localSearch(), const ConstructionMethod &constructionMethod=construction_method_factory::heuristicSolution(), const ConstructionMethod &diverseConstructionMethod=construction_method_factory::heuristicSolution(), size_t sketchSize=0, const MigrationPolicy &migrationPolicy=MigrationPolicy(), const NumaPlacement &numaPlacement=NumaPlacement());
+
+		/*
+		 * Steady-state variant without barriers: every thread repeatedly combines two random members of a shared reference set, improves the offspring
+		 * and inserts it, replacing the worst elite individual if it is better or else the closest diverse individual if it is better than that one.
+		 * Members are only locked while their solution pointer is read or replaced. Stop functions see one iteration per (elite+diverse)/2 offspring
+		 */
+		traffic::Solution asynchronousScatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const ImprovementMethod &improvementMethod=improvement_method_factory::localSearch(), const ConstructionMethod &constructionMethod=construction_method_factory::heuristicSolution(), const ConstructionMethod &diverseConstructionMethod=construction_method_factory::heuristicSolution());
+
+		/*
+		 * Runs independent constructionMethod + improvementMethod starts on every thread until timeBudget runs out.
+		 * Each start is improved for up to localSearchIterations, checked in segments, and is abandoned once its penalty
+		 * exceeds the best penalty found by any thread by more than pruningTolerance (0.1 = 10%)
+		 */
+		traffic::Solution multiStartLocalSearch (const traffic::Graph& graph, std::chrono::high_resolution_clock::duration timeBudget, size_t localSearchIterations, double pruningTolerance, unsigned numberOfThreads, const ImprovementMethod &improvementMethod=improvement_method_factory::localSearch(), const ConstructionMethod &constructionMethod=construction_method_factory::heuristicSolution());
+
+		/*
+		 * Splits the graph into numberOfParts parts with partition::multilevelPartition and solves the subgraph induced by each part
+		 * with subproblemMethod, several parts at a time. The timings of each connected piece of a part are then shifted by the cyclic offset
+		 * that best fits the pieces already placed, and an active vertex local search started from the cut vertices reconciles the boundaries
+		 */
+		traffic::Solution partitionedSearch (const traffic::Graph& graph, unsigned numberOfParts, const ConstructionMethod &subproblemMethod, unsigned numberOfThreads);
 	}
 };
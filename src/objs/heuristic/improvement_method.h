@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include "stop_policy.h"
+#include <functional>
+#include <type_traits>
+
+namespace heuristic {
+
+	typedef std::function<void(const traffic::Graph&, traffic::Solution&, const StopFunction&)> ImprovementFunction;
+
+	/*
+	 * Improves a solution in place, so searches improving the same buffers every iteration allocate nothing for them.
+	 * Functions returning a new solution are still accepted, their result being moved into the improved solution
+	 */
+	class ImprovementMethod {
+		private:
+			ImprovementFunction improveInPlace;
+
+			template<typename Function>
+			using returnsSolution = std::is_invocable_r<traffic::Solution, Function&, const traffic::Graph&, const traffic::Solution&, const StopFunction&>;
+			// functions taking a const solution can also be called with a mutable one, so those returning a solution are told apart first
+			template<typename Function>
+			using improvesInPlace = std::integral_constant<bool, std::is_invocable<Function&, const traffic::Graph&, traffic::Solution&, const StopFunction&>::value && !returnsSolution<Function>::value>;
+		public:
+			ImprovementMethod (void) = default;
+
+			template<typename Function, typename std::enable_if<improvesInPlace<Function>::value, int>::type = 0>
+			ImprovementMethod (Function function) :
+				improveInPlace(std::move(function))
+			{}
+
+			template<typename Function, typename std::enable_if<returnsSolution<Function>::value, int>::type = 0>
+			ImprovementMethod (Function function) :
+				improveInPlace([function](const traffic::Graph& graph, traffic::Solution& solution, const StopFunction& stopFunction) {
+					solution = function(graph, solution, stopFunction);
+				})
+			{}
+
+			inline void improve (const traffic::Graph& graph, traffic::Solution& solution, const StopFunction& stopFunction) const {
+				this->improveInPlace(graph, solution, stopFunction);
+			}
+
+			// improves a copy of initialSolution, allocating a new solution on every call
+			inline traffic::Solution operator() (const traffic::Graph& graph, const traffic::Solution& initialSolution, const StopFunction& stopFunction) const {
+				traffic::Solution solution(initialSolution);
+				this->improveInPlace(graph, solution, stopFunction);
+				return solution;
+			}
+
+			explicit operator bool (void) const {
+				return static_cast<bool>(this->improveInPlace);
+			}
+	};
+
+}
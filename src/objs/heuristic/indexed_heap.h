@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace heuristic {
+
+	/*
+	 * Binary heap of the items 0..numberOfItems-1, with above(a, b) true when a belongs above b. The position of every item is tracked,
+	 * so an item whose key changed can be sifted back into place and any item can be removed in O(log n)
+	 */
+	template<typename Above>
+	class IndexedHeap {
+		private:
+			static constexpr size_t ABSENT = std::numeric_limits<size_t>::max();
+			std::vector<size_t> items;
+			std::vector<size_t> positionOf;
+			Above above;
+
+			void place (size_t position, size_t item) {
+				this->items[position] = item;
+				this->positionOf[item] = position;
+			}
+
+			void siftUp (size_t position) {
+				auto item = this->items[position];
+				while (position > 0 && this->above(item, this->items[(position-1)/2])) {
+					this->place(position, this->items[(position-1)/2]);
+					position = (position-1)/2;
+				}
+				this->place(position, item);
+			}
+
+			void siftDown (size_t position) {
+				auto item = this->items[position];
+				while (2*position+1 < this->items.size()) {
+					auto child = 2*position+1;
+					if (child+1 < this->items.size() && this->above(this->items[child+1], this->items[child])) {
+						child++;
+					}
+					if (!this->above(this->items[child], item)) {
+						break;
+					}
+					this->place(position, this->items[child]);
+					position = child;
+				}
+				this->place(position, item);
+			}
+		public:
+			IndexedHeap (size_t numberOfItems, Above above) :
+				positionOf(numberOfItems, ABSENT),
+				above(above)
+			{
+				this->items.reserve(numberOfItems);
+			}
+
+			void push (size_t item) {
+				this->items.push_back(item);
+				this->siftUp(this->items.size()-1);
+			}
+
+			size_t top (void) const {
+				return this->items[0];
+			}
+
+			size_t size (void) const {
+				return this->items.size();
+			}
+
+			// restores the heap after the key of item changed
+			void update (size_t item) {
+				this->siftUp(this->positionOf[item]);
+				this->siftDown(this->positionOf[item]);
+			}
+
+			void remove (size_t item) {
+				auto position = this->positionOf[item];
+				auto last = this->items.back();
+				this->positionOf[item] = ABSENT;
+				this->items.pop_back();
+				if (position < this->items.size()) {
+					this->place(position, last);
+					this->update(last);
+				}
+			}
+
+			// item now goes by newItem, which is not in the heap, with the same key
+			void relabel (size_t item, size_t newItem) {
+				auto position = this->positionOf[item];
+				this->positionOf[item] = ABSENT;
+				this->place(position, newItem);
+			}
+	};
+
+	template<typename Above>
+	IndexedHeap<Above> indexedHeap (size_t numberOfItems, Above above) {
+		return IndexedHeap<Above>(numberOfItems, above);
+	}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include "../rng/random_stream.h"
+#include "stop_policy.h"
+
+namespace heuristic {
+
+	/*
+	 * Random descent: each iteration moves a random vertex to a random timing and keeps the move if it lowers the vertex penalty.
+	 * StopPolicy is any callable taking const Metrics& (see stop_policy.h), which lets the compiler inline the stop check
+	 */
+	template<typename StopPolicy>
+	void localSearchInPlace(const traffic::Graph& graph, traffic::Solution& solution, StopPolicy stopCriteriaNotMet) {
+		traffic::TimeUnit currentTiming, currentPenalty;
+		traffic::TimeUnit perturbationTiming, perturbationPenalty;
+		traffic::Vertex vertex;
+		bool iterationHadNoImprovement;
+		Metrics metrics;
+
+		rng::bounded_stream vertexPicker(graph.getNumberOfVertices());
+		rng::bounded_stream timingPicker(graph.getCycle());
+
+		metrics.numberOfIterations = 0;
+		metrics.numberOfIterationsWithoutImprovement = 0;
+		metrics.executionBegin = std::chrono::high_resolution_clock::now();
+		while (stopCriteriaNotMet(metrics)) {
+			iterationHadNoImprovement = true;
+
+			vertex = vertexPicker();
+
+			currentTiming = solution[vertex];
+			currentPenalty = graph.vertexPenalty(vertex, solution);
+			perturbationTiming = timingPicker();
+			solution[vertex] = perturbationTiming;
+			perturbationPenalty = graph.vertexPenalty(vertex, solution);
+
+			if (perturbationPenalty < currentPenalty) {
+				iterationHadNoImprovement = false;
+			} else {
+				solution[vertex] = currentTiming;
+			}
+
+			metrics.numberOfIterations++;
+			if (iterationHadNoImprovement) {
+				metrics.numberOfIterationsWithoutImprovement++;
+			} else {
+				metrics.numberOfIterationsWithoutImprovement = 0;
+			}
+		}
+	}
+
+	template<typename StopPolicy>
+	traffic::Solution localSearchHeuristic(const traffic::Graph& graph, const traffic::Solution& initialSolution, StopPolicy stopCriteriaNotMet) {
+		traffic::Solution solution(initialSolution);
+		localSearchInPlace(graph, solution, stopCriteriaNotMet);
+		return solution;
+	}
+
+}
@@ -0,0 +1,295 @@
+#include "migration_transport.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define LISTENER_POLL_MILLISECONDS 100
+#define MESSAGE_TIMEOUT_SECONDS 5
+#define MAXIMUM_MESSAGE_TIMINGS (1u << 28)
+#define MAXIMUM_PENDING_CONNECTIONS 64
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+sockaddr_un unixSocketAddress (const string& path) {
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path)) {
+		throw invalid_argument("socket path must be shorter than " + to_string(sizeof(address.sun_path)) + " characters: " + path);
+	}
+	strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path)-1);
+	return address;
+}
+
+enum class TransferProgress { COMPLETE, PENDING, FAILED };
+
+// writes buffer without blocking until size bytes, counted by bytesWritten across calls, have been sent
+TransferProgress writeAvailable (int socket, const void* buffer, size_t size, size_t& bytesWritten) {
+	auto bytes = static_cast<const char*>(buffer);
+	while (bytesWritten < size) {
+		auto written = ::send(socket, bytes + bytesWritten, size - bytesWritten, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return TransferProgress::PENDING;
+		}
+		if (written <= 0) {
+			return TransferProgress::FAILED;
+		}
+		bytesWritten += written;
+	}
+	return TransferProgress::COMPLETE;
+}
+
+// reads into buffer without blocking until size bytes, counted by bytesRead across calls, have arrived
+TransferProgress readAvailable (int socket, void* buffer, size_t size, size_t& bytesRead) {
+	auto bytes = static_cast<char*>(buffer);
+	while (bytesRead < size) {
+		auto received = ::recv(socket, bytes + bytesRead, size - bytesRead, MSG_DONTWAIT);
+		if (received < 0 && errno == EINTR) {
+			continue;
+		}
+		if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return TransferProgress::PENDING;
+		}
+		if (received <= 0) {
+			return TransferProgress::FAILED;
+		}
+		bytesRead += received;
+	}
+	return TransferProgress::COMPLETE;
+}
+
+/*
+ * Message being read from one connection, as a header of the count and the number of vertices of the migrants followed by their timings.
+ * Bytes are read as they arrive, so the listener can move on to other connections whenever this one has nothing ready
+ */
+struct IncomingMessage {
+	int connection;
+	chrono::steady_clock::time_point deadline;
+	uint32_t header[2];
+	size_t headerBytes = 0;
+	vector<Solution> migrants;
+	size_t migrant = 0;
+	size_t migrantBytes = 0;
+
+	TransferProgress readAvailable (void) {
+		if (this->headerBytes < sizeof(this->header)) {
+			auto progress = ::readAvailable(this->connection, this->header, sizeof(this->header), this->headerBytes);
+			if (progress != TransferProgress::COMPLETE) {
+				return progress;
+			}
+			if ((uint64_t) this->header[0]*this->header[1] > MAXIMUM_MESSAGE_TIMINGS) {
+				return TransferProgress::FAILED;
+			}
+			this->migrants.resize(this->header[0], Solution(this->header[1]));
+		}
+
+		while (this->migrant < this->migrants.size()) {
+			auto& solution = this->migrants[this->migrant];
+			auto progress = ::readAvailable(this->connection, solution.data(), solution.size()*sizeof(TimeUnit), this->migrantBytes);
+			if (progress != TransferProgress::COMPLETE) {
+				return progress;
+			}
+			this->migrant++;
+			this->migrantBytes = 0;
+		}
+		return TransferProgress::COMPLETE;
+	}
+};
+
+UnixSocketTransport::UnixSocketTransport (const string& socketPath, const vector<string>& neighborPaths, size_t inboxCapacity) :
+	socketPath(socketPath),
+	neighborPaths(neighborPaths),
+	stopSignal(false),
+	inboxCapacity(inboxCapacity)
+{
+	if (inboxCapacity < 1) {
+		throw invalid_argument("inboxCapacity must be greater than 0");
+	}
+	auto address = unixSocketAddress(socketPath);
+	for (auto& neighborPath : neighborPaths) {
+		unixSocketAddress(neighborPath);
+	}
+
+	// a socket file left behind by an earlier run would make bind fail, but any other file at the path is not ours to remove
+	struct stat existing;
+	if (lstat(socketPath.c_str(), &existing) == 0) {
+		if (!S_ISSOCK(existing.st_mode)) {
+			throw invalid_argument("socketPath already exists and is not a socket: " + socketPath);
+		}
+		unlink(socketPath.c_str());
+	}
+
+	this->listeningSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (this->listeningSocket < 0) {
+		throw system_error(errno, generic_category(), "could not create socket");
+	}
+
+	// accepting never blocks, so the listener can take in every pending connection and go back to polling
+	if (fcntl(this->listeningSocket, F_SETFL, O_NONBLOCK) < 0 || bind(this->listeningSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(this->listeningSocket, SOMAXCONN) < 0) {
+		auto error = errno;
+		close(this->listeningSocket);
+		throw system_error(error, generic_category(), "could not listen on " + socketPath);
+	}
+
+	this->listener = thread(&UnixSocketTransport::listen, this);
+}
+
+UnixSocketTransport::~UnixSocketTransport (void) {
+	this->stopSignal.store(true);
+	this->listener.join();
+	close(this->listeningSocket);
+	unlink(this->socketPath.c_str());
+}
+
+void UnixSocketTransport::listen (void) {
+	vector<IncomingMessage> messages;
+	vector<pollfd> polled;
+
+	while (!this->stopSignal.load()) {
+		// past the limit, further neighbors wait in the backlog of the listening socket
+		polled.assign(1, {this->listeningSocket, (short) (messages.size() < MAXIMUM_PENDING_CONNECTIONS ? POLLIN : 0), 0});
+		for (auto& message : messages) {
+			polled.push_back({message.connection, POLLIN, 0});
+		}
+		if (poll(polled.data(), polled.size(), LISTENER_POLL_MILLISECONDS) < 0) {
+			continue;
+		}
+
+		auto now = chrono::steady_clock::now();
+		for (size_t i = 0; i < messages.size(); i++) {
+			auto& message = messages[i];
+			auto progress = polled[i+1].revents != 0 ? message.readAvailable() : TransferProgress::PENDING;
+			// a neighbor that stalls mid-message is dropped, the others are read meanwhile
+			if (progress == TransferProgress::PENDING && now > message.deadline) {
+				progress = TransferProgress::FAILED;
+			}
+			if (progress != TransferProgress::PENDING) {
+				close(message.connection);
+				message.connection = -1;
+				if (progress == TransferProgress::COMPLETE) {
+					this->deliver(message.migrants);
+				}
+			}
+		}
+		messages.erase(remove_if(messages.begin(), messages.end(), [](const IncomingMessage& message) { return message.connection < 0; }), messages.end());
+
+		if (polled[0].revents & POLLIN) {
+			while (messages.size() < MAXIMUM_PENDING_CONNECTIONS) {
+				int connection = accept(this->listeningSocket, nullptr, nullptr);
+				if (connection < 0) {
+					break;
+				}
+				messages.emplace_back();
+				messages.back().connection = connection;
+				messages.back().deadline = now + chrono::seconds(MESSAGE_TIMEOUT_SECONDS);
+			}
+		}
+	}
+
+	for (auto& message : messages) {
+		close(message.connection);
+	}
+}
+
+void UnixSocketTransport::deliver (vector<Solution>& migrants) {
+	lock_guard<mutex> guard(this->inboxLock);
+	for (auto& migrant : migrants) {
+		this->inbox.push_back(move(migrant));
+	}
+	while (this->inbox.size() > this->inboxCapacity) {
+		this->inbox.pop_front();
+	}
+}
+
+void UnixSocketTransport::send (const vector<Solution>& emigrants) {
+	if (emigrants.empty()) {
+		return;
+	}
+
+	uint32_t header[2] = {(uint32_t) emigrants.size(), (uint32_t) emigrants[0].size()};
+	for (auto& emigrant : emigrants) {
+		if (emigrant.size() != header[1]) {
+			throw invalid_argument("every emigrant must have the same number of vertices");
+		}
+	}
+
+	// serialized once and written to every neighbor at once, as fast as each one reads
+	vector<char> message(sizeof(header) + (size_t) header[0]*header[1]*sizeof(TimeUnit));
+	auto position = message.data();
+	memcpy(position, header, sizeof(header));
+	position += sizeof(header);
+	for (auto& emigrant : emigrants) {
+		memcpy(position, emigrant.data(), emigrant.size()*sizeof(TimeUnit));
+		position += emigrant.size()*sizeof(TimeUnit);
+	}
+
+	vector<pollfd> connections;
+	for (auto& neighborPath : this->neighborPaths) {
+		auto address = unixSocketAddress(neighborPath);
+		int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (connection < 0) {
+			continue;
+		}
+		// neighbors that have not started yet, have already finished, or whose backlog is full simply miss these emigrants
+		if (fcntl(connection, F_SETFL, O_NONBLOCK) == 0 && connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+			connections.push_back({connection, POLLOUT, 0});
+		} else {
+			close(connection);
+		}
+	}
+
+	// a neighbor that is alive but not reading is dropped at the same deadline its listener would enforce
+	auto deadline = chrono::steady_clock::now() + chrono::seconds(MESSAGE_TIMEOUT_SECONDS);
+	vector<size_t> bytesWritten(connections.size(), 0);
+	size_t pending = connections.size();
+	while (pending > 0) {
+		for (size_t i = 0; i < connections.size(); i++) {
+			if (connections[i].fd < 0 || (connections[i].revents == 0 && bytesWritten[i] > 0)) {
+				continue;
+			}
+			if (writeAvailable(connections[i].fd, message.data(), message.size(), bytesWritten[i]) != TransferProgress::PENDING) {
+				close(connections[i].fd);
+				// poll ignores negative descriptors
+				connections[i].fd = -1;
+				pending--;
+			}
+		}
+
+		auto remaining = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+		if (pending == 0 || remaining <= 0) {
+			break;
+		}
+		poll(connections.data(), connections.size(), remaining);
+	}
+
+	for (auto& connection : connections) {
+		if (connection.fd >= 0) {
+			close(connection.fd);
+		}
+	}
+}
+
+vector<Solution> UnixSocketTransport::receive (void) {
+	lock_guard<mutex> guard(this->inboxLock);
+	vector<Solution> received(make_move_iterator(this->inbox.begin()), make_move_iterator(this->inbox.end()));
+	this->inbox.clear();
+	return received;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace heuristic {
+
+	/*
+	 * Carries migrants between the islands of an island-model search, which may live in other processes or on other machines.
+	 * Neither call may wait for the other islands, since each island migrates on its own schedule and may already have stopped
+	 */
+	class MigrationTransport {
+		public:
+			virtual ~MigrationTransport (void) = default;
+
+			// hands the emigrants to the neighboring islands, dropping them for any neighbor that cannot be reached
+			virtual void send (const std::vector<traffic::Solution>& emigrants) = 0;
+			// every solution that arrived since the last call
+			virtual std::vector<traffic::Solution> receive (void) = 0;
+	};
+
+	/*
+	 * Transport over Unix domain stream sockets for islands running on the same machine. The island listens on socketPath, where a background
+	 * thread accepts every neighbor's connection and reads its message into an inbox, so senders never wait for the island to reach a migration.
+	 * The listener polls all open connections at once and reads whatever each has ready, so a neighbor stalling mid-message delays no other,
+	 * and is dropped once its message takes longer than a few seconds. The inbox keeps only the inboxCapacity most recent migrants,
+	 * so an island that migrates rarely, or has stopped receiving, does not accumulate its neighbors' migrants without bound.
+	 * Each send opens one connection per neighbor path and writes the emigrants as a count, the number of vertices and then their timings,
+	 * to all neighbors at once, giving up on any neighbor that has not taken the whole message within the same few seconds.
+	 * An existing socket file at socketPath is replaced, while any other kind of file makes the constructor throw
+	 */
+	class UnixSocketTransport : public MigrationTransport {
+		private:
+			std::string socketPath;
+			std::vector<std::string> neighborPaths;
+			int listeningSocket;
+			std::atomic<bool> stopSignal;
+			size_t inboxCapacity;
+			std::mutex inboxLock;
+			std::deque<traffic::Solution> inbox;
+			std::thread listener;
+
+			void listen (void);
+			// adds the migrants of a complete message to the inbox, dropping the oldest ones beyond its capacity
+			void deliver (std::vector<traffic::Solution>& migrants);
+		public:
+			UnixSocketTransport (const std::string& socketPath, const std::vector<std::string>& neighborPaths, size_t inboxCapacity=256);
+			~UnixSocketTransport (void);
+
+			UnixSocketTransport (const UnixSocketTransport&) = delete;
+			UnixSocketTransport& operator= (const UnixSocketTransport&) = delete;
+
+			void send (const std::vector<traffic::Solution>& emigrants) override;
+			std::vector<traffic::Solution> receive (void) override;
+	};
+
+}
@@ -0,0 +1,258 @@
+#include "heuristic.h"
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <queue>
+
+#define MINIMUM_COARSENING_RATIO 0.9
+
+using namespace traffic;
+using namespace heuristic;
+using namespace std;
+
+struct Level {
+	// the original graph is not owned by its level, every coarser graph is
+	const Graph* graph;
+	unique_ptr<Graph> ownedGraph;
+	Vertex numberOfVertices;
+	// number of edges of the original graph merged into each edge, indexed like the adjacency list
+	vector<unordered_map<Vertex, unsigned>> multiplicity;
+	// vertex of the next coarser level each vertex was merged into, and its timing relative to it
+	vector<Vertex> coarseVertexOf;
+	vector<TimeUnit> offsetOf;
+};
+
+unsigned multiplicityOf (const Level& level, Vertex v, Vertex u) {
+	if (level.multiplicity.empty()) {
+		return 1;
+	}
+	return level.multiplicity[v].at(u);
+}
+
+/*
+ * Matches every vertex with the unmatched neighbor it shares the most original edges with, and merges them with an offset of +w,
+ * which gives the contracted edge its minimum penalty. An edge (a, b) between merged vertices X and Y with offsets o_a and o_b then has
+ * penalty f_w(T_Y - T_X + o_b - o_a), where f_w(x) = d(x - w) + d(x + w). A graph edge can only express f_W(T_Y - T_X), so the coarse edge
+ * takes W = |w - |o_b - o_a||, whose optimal interval lies inside the optimal interval of the original edge whenever |o_b - o_a| <= w.
+ * Parallel edges are summed in multiplicity but keep the weight of the first one found
+ */
+Level coarsen (Level& level, mt19937& randomEngine) {
+	const Graph& graph = *level.graph;
+	Vertex nVertices = graph.getNumberOfVertices();
+	TimeUnit cycle = graph.getCycle();
+	Vertex unmatched = nVertices;
+	vector<Vertex> visitOrder(nVertices);
+	Vertex numberOfCoarseVertices = 0;
+	Level coarseLevel;
+
+	level.coarseVertexOf.assign(nVertices, unmatched);
+	level.offsetOf.assign(nVertices, 0);
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		visitOrder[v] = v;
+	}
+	shuffle(visitOrder.begin(), visitOrder.end(), randomEngine);
+
+	for (auto v : visitOrder) {
+		if (level.coarseVertexOf[v] != unmatched) {
+			continue;
+		}
+
+		Vertex match = unmatched;
+		unsigned heaviestMultiplicity = 0;
+		for (auto& neighbor : graph.neighborsOf(v)) {
+			auto neighborMultiplicity = multiplicityOf(level, v, neighbor.first);
+			if (level.coarseVertexOf[neighbor.first] == unmatched && neighbor.first != v && neighborMultiplicity > heaviestMultiplicity) {
+				match = neighbor.first;
+				heaviestMultiplicity = neighborMultiplicity;
+			}
+		}
+
+		level.coarseVertexOf[v] = numberOfCoarseVertices;
+		if (match != unmatched) {
+			level.coarseVertexOf[match] = numberOfCoarseVertices;
+			level.offsetOf[match] = graph.neighborsOf(v).at(match)%cycle;
+		}
+		numberOfCoarseVertices++;
+	}
+
+	auto adjacencyList = new unordered_map<Vertex, Weight>[numberOfCoarseVertices];
+	coarseLevel.multiplicity.resize(numberOfCoarseVertices);
+	for (Vertex a = 0; a < nVertices; a++) {
+		auto coarseA = level.coarseVertexOf[a];
+		for (auto& neighbor : graph.neighborsOf(a)) {
+			auto b = neighbor.first;
+			auto coarseB = level.coarseVertexOf[b];
+			if (coarseA == coarseB) {
+				continue;
+			}
+
+			TimeUnit offsetDifference = ((level.offsetOf[b] - level.offsetOf[a])%cycle + cycle)%cycle;
+			offsetDifference = min(offsetDifference, cycle - offsetDifference);
+			Weight coarseWeight = abs(neighbor.second%cycle - offsetDifference);
+
+			// the edge is set in both directions at once, so its weight stays symmetric when parallel edges disagree
+			if (adjacencyList[coarseA].emplace(coarseB, coarseWeight).second) {
+				adjacencyList[coarseB][coarseA] = coarseWeight;
+			}
+			coarseLevel.multiplicity[coarseA][coarseB] += multiplicityOf(level, a, b);
+		}
+	}
+
+	coarseLevel.ownedGraph.reset(new AdjacencyListGraph(adjacencyList, numberOfCoarseVertices, cycle));
+	coarseLevel.graph = coarseLevel.ownedGraph.get();
+	coarseLevel.numberOfVertices = numberOfCoarseVertices;
+	return coarseLevel;
+}
+
+/*
+ * Active vertex search over clusters of the original graph: vertex v belongs to cluster clusterOf[v] and has timing T + offsetOf[v], T being the timing of its cluster.
+ * Moving a cluster only changes the penalty of the original edges (a, b) leaving it, each adding the anchors t_b - o_a - w and t_b - o_a + w for T,
+ * so moves are evaluated on the original graph however much the coarse graphs approximated it
+ */
+void refineClusters (const Graph& graph, Solution& solution, const vector<Vertex>& clusterOf, const vector<TimeUnit>& offsetOf, Vertex numberOfClusters, mt19937& randomEngine) {
+	Vertex nVertices = graph.getNumberOfVertices();
+	TimeUnit cycle = graph.getCycle();
+	vector<size_t> membersBegin(numberOfClusters+1, 0);
+	vector<Vertex> members(nVertices);
+	vector<Vertex> initialOrder(numberOfClusters);
+	vector<bool> isActive(numberOfClusters, true);
+	queue<Vertex> activeClusters;
+	vector<TimeUnit> anchors;
+
+	auto wrap = [cycle](TimeUnit timing) {
+		return ((timing%cycle) + cycle)%cycle;
+	};
+	auto circularDistance = [cycle](TimeUnit difference) {
+		difference = ((difference%cycle) + cycle)%cycle;
+		return min(difference, cycle - difference);
+	};
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		membersBegin[clusterOf[v]+1]++;
+	}
+	for (Vertex cluster = 0; cluster < numberOfClusters; cluster++) {
+		membersBegin[cluster+1] += membersBegin[cluster];
+	}
+	{
+		vector<size_t> position(membersBegin.begin(), membersBegin.end()-1);
+		for (Vertex v = 0; v < nVertices; v++) {
+			members[position[clusterOf[v]]++] = v;
+		}
+	}
+
+	for (Vertex cluster = 0; cluster < numberOfClusters; cluster++) {
+		initialOrder[cluster] = cluster;
+	}
+	shuffle(initialOrder.begin(), initialOrder.end(), randomEngine);
+	for (auto cluster : initialOrder) {
+		activeClusters.push(cluster);
+	}
+
+	while (!activeClusters.empty()) {
+		auto cluster = activeClusters.front();
+		activeClusters.pop();
+		isActive[cluster] = false;
+
+		if (membersBegin[cluster] == membersBegin[cluster+1]) {
+			continue;
+		}
+
+		auto firstMember = members[membersBegin[cluster]];
+		TimeUnit clusterTiming = wrap(solution[firstMember] - offsetOf[firstMember]);
+		TimeUnit currentPenalty = 0;
+
+		anchors.clear();
+		for (size_t m = membersBegin[cluster]; m < membersBegin[cluster+1]; m++) {
+			auto a = members[m];
+			for (auto& neighbor : graph.neighborsOf(a)) {
+				if (clusterOf[neighbor.first] == cluster) {
+					continue;
+				}
+				TimeUnit weight = neighbor.second%cycle;
+				TimeUnit base = solution[neighbor.first] - offsetOf[a];
+				anchors.push_back(wrap(base - weight));
+				anchors.push_back(wrap(base + weight));
+				currentPenalty += circularDistance(clusterTiming - anchors[anchors.size()-2]) + circularDistance(clusterTiming - anchors.back());
+			}
+		}
+
+		auto best = optimalTimingAmongAnchors(anchors, cycle, clusterTiming);
+		if (best.penalty < currentPenalty) {
+			TimeUnit shift = best.timing - clusterTiming;
+			for (size_t m = membersBegin[cluster]; m < membersBegin[cluster+1]; m++) {
+				auto a = members[m];
+				solution[a] = wrap(solution[a] + shift);
+			}
+			for (size_t m = membersBegin[cluster]; m < membersBegin[cluster+1]; m++) {
+				for (auto& neighbor : graph.neighborsOf(members[m])) {
+					auto neighborCluster = clusterOf[neighbor.first];
+					if (!isActive[neighborCluster]) {
+						isActive[neighborCluster] = true;
+						activeClusters.push(neighborCluster);
+					}
+				}
+			}
+		}
+	}
+}
+
+Solution heuristic::multilevelSearch (const Graph& graph, Vertex coarsestNumberOfVertices, const ConstructionMethod& coarsestLevelMethod) {
+	if (coarsestNumberOfVertices < 2) {
+		throw invalid_argument("coarsestNumberOfVertices must be greater than 1");
+	}
+
+	random_device seeder;
+	mt19937 randomEngine(seeder());
+	vector<Level> levels;
+	Vertex nVertices = graph.getNumberOfVertices();
+	TimeUnit cycle = graph.getCycle();
+
+	levels.emplace_back();
+	levels.back().graph = &graph;
+	levels.back().numberOfVertices = nVertices;
+	while (levels.back().graph->getNumberOfVertices() > coarsestNumberOfVertices) {
+		Vertex finerNumberOfVertices = levels.back().graph->getNumberOfVertices();
+		auto coarseLevel = coarsen(levels.back(), randomEngine);
+		if (coarseLevel.graph->getNumberOfVertices() > MINIMUM_COARSENING_RATIO*finerNumberOfVertices) {
+			break;
+		}
+		// only the matching of the finer level is still needed
+		levels.back().ownedGraph.reset();
+		levels.back().graph = nullptr;
+		levels.back().multiplicity.clear();
+		levels.push_back(move(coarseLevel));
+	}
+
+	vector<Vertex> clusterOf(nVertices);
+	vector<TimeUnit> offsetOf(nVertices);
+	// composes the matchings of the levels below, so that original vertex v has timing T + offsetOf[v] when cluster clusterOf[v] has timing T
+	auto clustersOfLevel = [&](size_t level) {
+		for (Vertex v = 0; v < nVertices; v++) {
+			clusterOf[v] = v;
+			offsetOf[v] = 0;
+			for (size_t below = 0; below < level; below++) {
+				offsetOf[v] = (offsetOf[v] + levels[below].offsetOf[clusterOf[v]])%cycle;
+				clusterOf[v] = levels[below].coarseVertexOf[clusterOf[v]];
+			}
+		}
+	};
+
+	auto coarsestLevel = levels.size()-1;
+	Solution coarsestSolution = coarsestLevelMethod(*levels[coarsestLevel].graph);
+	Solution solution(nVertices);
+
+	clustersOfLevel(coarsestLevel);
+	for (Vertex v = 0; v < nVertices; v++) {
+		solution[v] = (coarsestSolution[clusterOf[v]] + offsetOf[v])%cycle;
+	}
+
+	for (size_t level = coarsestLevel+1; level > 0; level--) {
+		clustersOfLevel(level-1);
+		refineClusters(graph, solution, clusterOf, offsetOf, levels[level-1].numberOfVertices, randomEngine);
+	}
+
+	return solution;
+}
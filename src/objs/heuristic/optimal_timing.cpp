@@ -0,0 +1,86 @@
+#include "heuristic.h"
+
+#include <vector>
+#include <algorithm>
+
+using namespace traffic;
+using namespace heuristic;
+using namespace std;
+
+/*
+ * The penalty of a vertex as a function of its timing t is a sum of circular distances |t - a|,
+ * one for each anchor a = t_u - w and a = t_u + w of every neighbor u.
+ * Between two consecutive anchors the sum is concave, so its minimum is always at an anchor.
+ * With the anchors sorted and duplicated over two cycles, prefix sums give the penalty at every anchor in amortized O(1),
+ * for a total of O(degree*log(degree))
+ */
+Perturbation heuristic::optimalTimingAmongAnchors (vector<TimeUnit>& anchors, TimeUnit cycle, TimeUnit currentTiming) {
+	thread_local vector<TimeUnit> prefixSum;
+	TimeUnit halfCycle = cycle/2;
+	TimeUnit anchor, nearPenalty, farPenalty;
+	Perturbation best = {currentTiming, numeric_limits<TimeUnit>::max()};
+	size_t numberOfAnchors, j, farBegin;
+
+	numberOfAnchors = anchors.size();
+	if (numberOfAnchors == 0) {
+		return {currentTiming, 0};
+	}
+
+	sort(anchors.begin(), anchors.end());
+	for (j = 0; j < numberOfAnchors; j++) {
+		anchors.push_back(anchors[j]+cycle);
+	}
+
+	prefixSum.resize(2*numberOfAnchors+1);
+	prefixSum[0] = 0;
+	for (j = 0; j < 2*numberOfAnchors; j++) {
+		prefixSum[j+1] = prefixSum[j] + anchors[j];
+	}
+
+	// anchors in [j, farBegin) are at most half a cycle ahead of anchors[j], anchors in [farBegin, j+numberOfAnchors) are closer going backwards
+	farBegin = 0;
+	for (j = 0; j < numberOfAnchors; j++) {
+		anchor = anchors[j];
+		farBegin = max(farBegin, j);
+		while (farBegin < j+numberOfAnchors && anchors[farBegin] - anchor <= halfCycle) {
+			farBegin++;
+		}
+
+		nearPenalty = (prefixSum[farBegin] - prefixSum[j]) - static_cast<TimeUnit>(farBegin-j)*anchor;
+		farPenalty = static_cast<TimeUnit>(j+numberOfAnchors-farBegin)*(anchor+cycle) - (prefixSum[j+numberOfAnchors] - prefixSum[farBegin]);
+
+		if (nearPenalty + farPenalty < best.penalty) {
+			best = {anchor, nearPenalty + farPenalty};
+		}
+	}
+
+	anchors.resize(numberOfAnchors);
+	return best;
+}
+
+template<typename NeighborFilter>
+Perturbation optimalTimingAmong (const Graph& graph, Vertex vertex, const Solution& solution, NeighborFilter isConsidered) {
+	thread_local vector<TimeUnit> anchors;
+	TimeUnit cycle = graph.getCycle();
+
+	anchors.clear();
+	for (auto& neighbor : graph.neighborsOf(vertex)) {
+		if (!isConsidered(neighbor.first)) {
+			continue;
+		}
+		TimeUnit weight = neighbor.second%cycle;
+		TimeUnit neighborTiming = solution[neighbor.first];
+		anchors.push_back((neighborTiming - weight + cycle)%cycle);
+		anchors.push_back((neighborTiming + weight)%cycle);
+	}
+
+	return optimalTimingAmongAnchors(anchors, cycle, solution[vertex]);
+}
+
+Perturbation heuristic::optimalTiming (const Graph& graph, Vertex vertex, const Solution& solution) {
+	return optimalTimingAmong(graph, vertex, solution, [](Vertex) { return true; });
+}
+
+Perturbation heuristic::optimalTiming (const Graph& graph, Vertex vertex, const Solution& solution, const vector<bool>& isAssigned) {
+	return optimalTimingAmong(graph, vertex, solution, [&](Vertex neighbor) { return isAssigned[neighbor]; });
+}
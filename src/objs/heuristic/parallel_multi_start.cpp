@@ -0,0 +1,64 @@
+#include "heuristic.h"
+#include "../parallel/macros.h"
+#include "../parallel/reusable_thread.h"
+
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+using namespace ::parallel;
+
+#define NUMBER_OF_SEGMENTS_PER_START 10
+
+Solution heuristic::parallel::multiStartLocalSearch (const Graph& graph, chrono::high_resolution_clock::duration timeBudget, size_t localSearchIterations, double pruningTolerance, unsigned numberOfThreads, const ImprovementMethod& improvementMethod, const ConstructionMethod& constructionMethod) {
+	if (numberOfThreads < 1) {
+		throw invalid_argument("numberOfThreads must be greater than 0");
+	}
+	if (pruningTolerance < 0) {
+		throw invalid_argument("pruningTolerance cannot be negative");
+	}
+
+	auto deadline = chrono::high_resolution_clock::now() + timeBudget;
+	atomic<TimeUnit> incumbentPenalty(numeric_limits<TimeUnit>::max());
+	mutex incumbentMutex;
+	Solution incumbent;
+
+	// each start is improved in segments so it can be abandoned as soon as it falls too far behind the incumbent
+	size_t segmentIterations = max(localSearchIterations/NUMBER_OF_SEGMENTS_PER_START, (size_t)1);
+	StopFunction segmentStopFunction = stop_function_factory::numberOfIterations(segmentIterations);
+
+	auto publish = [&](const Solution& solution, TimeUnit penalty) {
+		if (penalty < incumbentPenalty.load()) {
+			lock_guard<mutex> lock(incumbentMutex);
+			if (penalty < incumbentPenalty.load()) {
+				incumbent = solution;
+				incumbentPenalty.store(penalty);
+			}
+		}
+	};
+
+	thread_pile threads(numberOfThreads);
+	using_threads(threads);
+	for_each_thread {
+		do {
+			Solution solution = constructionMethod(graph);
+			TimeUnit penalty = graph.totalPenalty(solution);
+			publish(solution, penalty);
+
+			for (size_t searchedIterations = 0; searchedIterations < localSearchIterations && chrono::high_resolution_clock::now() < deadline; searchedIterations += segmentIterations) {
+				improvementMethod.improve(graph, solution, segmentStopFunction);
+				penalty = graph.totalPenalty(solution);
+				publish(solution, penalty);
+
+				if (penalty > incumbentPenalty.load()*(1.0+pruningTolerance)) {
+					break;
+				}
+			}
+		} while (chrono::high_resolution_clock::now() < deadline);
+	} end_for_each_thread;
+
+	return incumbent;
+}
@@ -0,0 +1,47 @@
+#include "heuristic.h"
+#include "parallel_scatter_search.h"
+#include "../parallel/macros.h"
+#include "../parallel/reusable_thread.h"
+
+#include <vector>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+using namespace ::parallel;
+
+void heuristic::parallel::initializePopulation (const Graph &graph, const vector<PopulationInitialization> &slices, unsigned numberOfThreads, const ImprovementMethod &improvementMethod) {
+	if (numberOfThreads < 1) {
+		throw invalid_argument("numberOfThreads must be greater than 0");
+	}
+
+	size_t numberOfIndividuals = 0;
+	for (auto& slice : slices) {
+		numberOfIndividuals += slice.individuals.size();
+	}
+
+	thread_pile threads(usable_threads(numberOfIndividuals, numberOfThreads));
+	thread_pile::slice_t availableThreads = threads;
+	initializePopulation(graph, slices, availableThreads, improvementMethod);
+}
+
+void heuristic::parallel::initializePopulation (const Graph &graph, const vector<PopulationInitialization> &slices, thread_pile::slice_t &availableThreads, const ImprovementMethod &improvementMethod) {
+	vector<pair<Individual*, const PopulationInitialization*>> individuals;
+
+	for (auto& slice : slices) {
+		for (auto& individual : PopulationSlice<Individual>(slice.individuals)) {
+			individuals.emplace_back(&individual, &slice);
+		}
+	}
+
+	using_threads(availableThreads);
+	dynamic_parallel_for (individuals.begin(), individuals.end()) {
+		auto& [individual, slice] = *i;
+		auto initialSolution = slice->constructionMethod(graph);
+		improvementMethod.improve(graph, initialSolution, slice->localSearchStopFunction);
+		individual->penalty = graph.totalPenalty(initialSolution);
+		individual->solution = move(initialSolution);
+		individual->minimumDistance = numeric_limits<TimeUnit>::max();
+		individual->estimatedMinimumDistance = numeric_limits<TimeUnit>::max();
+	} end_dynamic_parallel_for;
+}
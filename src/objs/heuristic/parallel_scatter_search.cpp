@@ -1,5 +1,7 @@
 #include "heuristic.h"
 #include "population.h"
+#include "indexed_heap.h"
+#include "parallel_scatter_search.h"
 #include "../parallel/macros.h"
 #include <vector>
 #include <random>
@@ -7,90 +9,181 @@
 #include <thread>
 #include <mutex>
 #include <sstream>
+#include <numeric>
+#include <limits>
+#include <memory>
 #include "../parallel/reusable_thread.h"
+#include "../parallel/numa.h"
 
 #include <iostream>
 
-//#define DELAYED_COMBINATION
-
 using namespace traffic;
 using namespace std;
 using namespace heuristic;
 using namespace ::parallel;
+using heuristic::parallel::IslandMigration;
+using heuristic::parallel::MigrationPolicy;
+using heuristic::parallel::NumaPlacement;
+using heuristic::parallel::PopulationInitialization;
+using heuristic::parallel::initializePopulation;
+using heuristic::parallel::exchangeDiscardedIndividuals;
 
-void recalculateDistances(
-		const Graph &graph,
-		const Individual& individual,
-		const vector<Individual>::iterator &begin,
-		const vector<Individual>::iterator &end,
-		thread_pile::slice_t &availableThreads
-) {
-	using_threads(availableThreads);
-	parallel_for (begin, end) {
-		auto currentDistance = distance(graph, individual.solution, i->solution);
-		if (currentDistance < i->minimumDistance) {
-			i->minimumDistance = currentDistance;
-		}
-	} end_parallel_for;
-}
+#define EXCHANGE_TILE_SIZE ((size_t) 16)
 
 bool lowestPenalty(const Individual& a, const Individual& b) {
 	return a.penalty < b.penalty;
 }
-bool greatestMinimumDistance(const Individual& a, const Individual& b) {
-	return a.minimumDistance > b.minimumDistance;
-}
-bool lowestMinimumDistance(const Individual& a, const Individual& b) {
-	return a.minimumDistance < b.minimumDistance;
-}
 
-void exchangeDiscardedIndividuals (
+void heuristic::parallel::exchangeDiscardedIndividuals (
 	const Graph &graph,
 	vector<ScatterSearchPopulation<Individual>> &populations,
 	size_t populationOffsetBegin,
 	size_t populationOffsetEnd,
 	PopulationInterface<Individual>& discardedPopulation,
+	DistanceCache &distanceCache,
+	const DistanceSketch &distanceSketch,
 	thread_pile::slice_t &availableThreads
 ) {
 	using_threads(availableThreads);
+	auto numberOfDiscarded = discardedPopulation.size();
+	if (numberOfDiscarded == 0) {
+		return;
+	}
+
+	auto distanceBetween = [&](const Individual& a, const Individual& b) {
+		return distanceSketch.isExact() ? distanceCache.distance(graph, a, b) : distanceSketch.estimatedDistance(a, b);
+	};
+
+	constexpr size_t NO_SLOT = numeric_limits<size_t>::max();
+	// one cache line per thread, since every thread updates its own while folding distances
+	struct alignas(64) ThreadFarthestSlot {
+		size_t slot;
+	};
+	vector<ThreadFarthestSlot> threadFarthestSlots(parallel_threads_end - parallel_threads_begin);
+
 	auto populationEnd = populations.begin()+populationOffsetEnd;
 	for (auto population_it = populations.begin()+populationOffsetBegin; population_it < populationEnd; population_it++) {
 		auto& population = *population_it;
 
-		parallel_for (discardedPopulation.begin(), discardedPopulation.end()) {
-			i->minimumDistance = numeric_limits<TimeUnit>::max();
-		} end_parallel_for;
-
 		// exchange elite individuals
-		auto bestDiscardedIndividual = min_element(discardedPopulation.begin(), discardedPopulation.end(), lowestPenalty);
+		auto bestDiscarded = indexedHeap(numberOfDiscarded, [&](size_t a, size_t b) {
+			return discardedPopulation[a].penalty < discardedPopulation[b].penalty;
+		});
+		for (size_t slot = 0; slot < numberOfDiscarded; slot++) {
+			bestDiscarded.push(slot);
+		}
 		for (auto& eliteIndividual : population.elite) {
-			if (eliteIndividual.penalty > bestDiscardedIndividual->penalty) {
-				swap(eliteIndividual, *bestDiscardedIndividual);
-				bestDiscardedIndividual = min_element(discardedPopulation.begin(), discardedPopulation.end(), lowestPenalty);
+			auto slot = bestDiscarded.top();
+			if (eliteIndividual.penalty > discardedPopulation[slot].penalty) {
+				swap(eliteIndividual, discardedPopulation[slot]);
+				bestDiscarded.update(slot);
+			}
+		}
+
+		if (distanceSketch.isExact()) {
+			size_t referenceTiles = (population.reference.size()+EXCHANGE_TILE_SIZE-1)/EXCHANGE_TILE_SIZE;
+			size_t discardedTiles = (numberOfDiscarded+EXCHANGE_TILE_SIZE-1)/EXCHANGE_TILE_SIZE;
+			vector<size_t> tiles(referenceTiles*discardedTiles);
+			iota(tiles.begin(), tiles.end(), 0);
+
+			dynamic_parallel_for (tiles.begin(), tiles.end()) {
+				auto referenceBegin = (*i/discardedTiles)*EXCHANGE_TILE_SIZE;
+				auto discardedBegin = (*i%discardedTiles)*EXCHANGE_TILE_SIZE;
+				auto referenceEnd = min(referenceBegin+EXCHANGE_TILE_SIZE, population.reference.size());
+				auto discardedEnd = min(discardedBegin+EXCHANGE_TILE_SIZE, numberOfDiscarded);
+				for (auto r = referenceBegin; r < referenceEnd; r++) {
+					for (auto d = discardedBegin; d < discardedEnd; d++) {
+						distanceCache.distance(graph, population.reference[r], discardedPopulation[d]);
+					}
+				}
+			} end_dynamic_parallel_for;
+		}
+
+		// the farthest discarded individual is tracked by every pass that changes their keys, ties going to the lowest slot
+		size_t farthestSlot = NO_SLOT;
+		auto keepFarther = [&](size_t& farthest, size_t slot) {
+			if (farthest == NO_SLOT || discardedPopulation[slot].minimumDistance > discardedPopulation[farthest].minimumDistance) {
+				farthest = slot;
 			}
+		};
 
-			recalculateDistances(graph, eliteIndividual, discardedPopulation.begin(), discardedPopulation.end(), availableThreads);
+		for (size_t slot = 0; slot < numberOfDiscarded; slot++) {
+			auto& discardedIndividual = discardedPopulation[slot];
+			discardedIndividual.estimatedMinimumDistance = numeric_limits<TimeUnit>::max();
+			for (auto& eliteIndividual : population.elite) {
+				discardedIndividual.estimatedMinimumDistance = min(discardedIndividual.estimatedMinimumDistance, distanceBetween(eliteIndividual, discardedIndividual));
+			}
+			discardedIndividual.minimumDistance = discardedIndividual.estimatedMinimumDistance;
+			keepFarther(farthestSlot, slot);
 		}
 
 		// exchange diverse individuals
-		auto bestDiverseIndividual = max_element(population.diverse.begin(), population.diverse.end(), greatestMinimumDistance);
-		bestDiscardedIndividual = max_element(discardedPopulation.begin(), discardedPopulation.end(), greatestMinimumDistance);
-		for (auto diverseIndividual = population.diverse.begin(); diverseIndividual < population.diverse.end(); diverseIndividual++) {
-			if (bestDiverseIndividual->minimumDistance > bestDiscardedIndividual->minimumDistance) {
-				iter_swap(diverseIndividual, bestDiverseIndividual);
-				bestDiverseIndividual = max_element(diverseIndividual+1, population.diverse.end(), greatestMinimumDistance);
+		auto& diverse = population.diverse;
+		auto bestDiverse = indexedHeap(diverse.size(), [&](size_t a, size_t b) {
+			return diverse[a].minimumDistance > diverse[b].minimumDistance;
+		});
+		for (size_t position = 0; position < diverse.size(); position++) {
+			bestDiverse.push(position);
+		}
+
+		// a refined minimum distance is kept until a lower estimate against a newly selected individual undercuts it
+		auto foldDistance = [](Individual& individual, TimeUnit distance) {
+			individual.estimatedMinimumDistance = min(individual.estimatedMinimumDistance, distance);
+			individual.minimumDistance = min(individual.minimumDistance, individual.estimatedMinimumDistance);
+		};
+
+		for (size_t selected = 0; selected < diverse.size(); selected++) {
+			auto position = bestDiverse.top();
+			auto& discardedIndividual = discardedPopulation[farthestSlot];
+			if (!distanceSketch.isExact() && abs(diverse[position].minimumDistance - discardedIndividual.minimumDistance) <= DistanceSketch::CLOSE_CALL_TOLERANCE*diverse[position].minimumDistance) {
+				discardedIndividual.minimumDistance = refineMinimumDistance(graph, discardedIndividual, population.elite.begin(), diverse.begin()+selected, distanceCache, distanceSketch);
+			}
+
+			bool selectedDiscarded = !(diverse[position].minimumDistance > discardedIndividual.minimumDistance);
+			if (selectedDiscarded) {
+				// the diverse individual in the way joins the discarded ones
+				bestDiverse.remove(selected);
+				swap(diverse[selected], discardedIndividual);
 			} else {
-				iter_swap(diverseIndividual, bestDiscardedIndividual);
-				bestDiscardedIndividual = max_element(discardedPopulation.begin(), discardedPopulation.end(), greatestMinimumDistance);
+				bestDiverse.remove(position);
+				if (position != selected) {
+					swap(diverse[selected], diverse[position]);
+					bestDiverse.relabel(selected, position);
+				}
 			}
-			if (population.diverse.end() - diverseIndividual > 1) {
-				recalculateDistances(graph, *diverseIndividual, discardedPopulation.begin(), discardedPopulation.end(), availableThreads);
+
+			if (selected+1 == diverse.size()) {
+				break;
+			}
+
+			// distances from a newly selected discarded individual to the others were not part of the tiled pass
+			auto& selectedIndividual = diverse[selected];
+			farthestSlot = NO_SLOT;
+			if (selectedDiscarded && distanceSketch.isExact()) {
+				// each thread finds the farthest individual of its own contiguous block, then the blocks are reduced in order
+				for (auto& threadFarthest : threadFarthestSlots) {
+					threadFarthest.slot = NO_SLOT;
+				}
+				parallel_for ((size_t) 0, numberOfDiscarded) {
+					foldDistance(discardedPopulation[i], distanceCache.distance(graph, selectedIndividual, discardedPopulation[i]));
+					keepFarther(threadFarthestSlots[thread_i].slot, i);
+				} end_parallel_for;
+				for (auto& threadFarthest : threadFarthestSlots) {
+					if (threadFarthest.slot != NO_SLOT) {
+						keepFarther(farthestSlot, threadFarthest.slot);
+					}
+				}
+			} else {
+				for (size_t slot = 0; slot < numberOfDiscarded; slot++) {
+					foldDistance(discardedPopulation[slot], distanceBetween(selectedIndividual, discardedPopulation[slot]));
+					keepFarther(farthestSlot, slot);
+				}
 			}
 		}
 	}
 }
 
-Population<Individual> bottomUpTreeDiversify(const Graph &graph, vector<ScatterSearchPopulation<Individual>> &population, size_t populationBegin, size_t populationEnd, size_t elitePopulationSize, size_t diversePopulationSize, thread_pile& allThreads) {
+Population<Individual> bottomUpTreeDiversify(const Graph &graph, vector<ScatterSearchPopulation<Individual>> &population, size_t populationBegin, size_t populationEnd, size_t elitePopulationSize, size_t diversePopulationSize, DistanceCache &distanceCache, const DistanceSketch &distanceSketch, thread_pile& allThreads) {
 
 	if (populationEnd - populationBegin < 2) {
 		Population<Individual> baseDiscartion;
@@ -105,17 +198,17 @@ Population<Individual> bottomUpTreeDiversify(const Graph &graph, vector<ScatterS
 		auto rightPopulationBegin = (populationBegin+populationEnd)/2;
 		auto& neighborThread = allThreads[rightPopulationBegin];
 
-		auto rightHalfFuture = neighborThread.exec([&]() {
-			rightDiscardedPopulation = bottomUpTreeDiversify(graph, population, rightPopulationBegin, populationEnd, elitePopulationSize/2, diversePopulationSize/2, allThreads);
+		auto rightHalfCompletion = neighborThread.exec([&]() {
+			rightDiscardedPopulation = bottomUpTreeDiversify(graph, population, rightPopulationBegin, populationEnd, elitePopulationSize/2, diversePopulationSize/2, distanceCache, distanceSketch, allThreads);
 		});
 
-		leftDiscardedPopulation = bottomUpTreeDiversify(graph, population, populationBegin, rightPopulationBegin, elitePopulationSize/2, diversePopulationSize/2, allThreads);
+		leftDiscardedPopulation = bottomUpTreeDiversify(graph, population, populationBegin, rightPopulationBegin, elitePopulationSize/2, diversePopulationSize/2, distanceCache, distanceSketch, allThreads);
 
-		rightHalfFuture.wait();
+		rightHalfCompletion.get();
 
 		auto availableThreads = allThreads.depth(1).slice(populationBegin, populationEnd);
-		exchangeDiscardedIndividuals(graph, population, populationBegin, rightPopulationBegin, rightDiscardedPopulation, availableThreads);
-		exchangeDiscardedIndividuals(graph, population, rightPopulationBegin, populationEnd, leftDiscardedPopulation, availableThreads);
+		exchangeDiscardedIndividuals(graph, population, populationBegin, rightPopulationBegin, rightDiscardedPopulation, distanceCache, distanceSketch, availableThreads);
+		exchangeDiscardedIndividuals(graph, population, rightPopulationBegin, populationEnd, leftDiscardedPopulation, distanceCache, distanceSketch, availableThreads);
 
 		Population<Individual> totalDiscardedPopulation;
 		totalDiscardedPopulation.reserve(rightDiscardedPopulation.size()+leftDiscardedPopulation.size());
@@ -132,157 +225,443 @@ Population<Individual> bottomUpTreeDiversify(const Graph &graph, vector<ScatterS
 	}
 }
 
-unsigned brianKernighanCountBitsSet (unsigned number) {
-	unsigned count = 0;
-	while (number > 0) {
-		number &= number-1;
-		count++;
+struct ThreadPopulationSize {
+	size_t elite;
+	size_t diverse;
+};
+
+/*
+ * Splits the reference set among the threads in pairs, since every pair of reference individuals makes one candidate, so the numbers of
+ * combinations per thread differ by at most one. Every thread gets one elite individual and the rest are dealt out in turn to threads with room left
+ */
+vector<ThreadPopulationSize> splitPopulation (size_t elitePopulationSize, size_t diversePopulationSize, unsigned numberOfThreads) {
+	size_t numberOfPairs = (elitePopulationSize+diversePopulationSize)/2;
+	vector<size_t> referenceSize(numberOfThreads), eliteSize(numberOfThreads, 1);
+	for (unsigned thread_i = 0; thread_i < numberOfThreads; thread_i++) {
+		referenceSize[thread_i] = 2*(numberOfPairs/numberOfThreads + (thread_i < numberOfPairs%numberOfThreads));
 	}
-	return count;
+
+	size_t remainingElite = elitePopulationSize - numberOfThreads;
+	for (unsigned thread_i = 0; remainingElite > 0; thread_i = (thread_i+1)%numberOfThreads) {
+		if (eliteSize[thread_i] < referenceSize[thread_i]) {
+			eliteSize[thread_i]++;
+			remainingElite--;
+		}
+	}
+
+	vector<ThreadPopulationSize> sizes(numberOfThreads);
+	for (unsigned thread_i = 0; thread_i < numberOfThreads; thread_i++) {
+		sizes[thread_i] = {eliteSize[thread_i], referenceSize[thread_i]-eliteSize[thread_i]};
+	}
+	return sizes;
 }
 
-void arrangePopulation (PopulationInterface<Individual*> &totalPopulation, PopulationInterface<Individual*> &population, unsigned thread_i) {
+/*
+ * Copies of the best elite and the most isolated diverse individuals of the given thread populations, numberOfMigrants of each
+ */
+vector<Solution> collectEmigrants (vector<ScatterSearchPopulation<Individual>> &populations, size_t populationBegin, size_t populationEnd, size_t numberOfMigrants) {
+	vector<const Individual*> eliteIndividuals, diverseIndividuals;
+	for (auto population = populations.begin()+populationBegin; population < populations.begin()+populationEnd; population++) {
+		for (auto& individual : population->elite) {
+			eliteIndividuals.push_back(&individual);
+		}
+		for (auto& individual : population->diverse) {
+			diverseIndividuals.push_back(&individual);
+		}
+	}
 
-	auto totalPopulationBegin = population.size()*thread_i;
-	auto totalPopulationEnd = totalPopulationBegin+population.size();
-	size_t total_i, population_i;
+	auto numberOfEliteEmigrants = min(numberOfMigrants, eliteIndividuals.size());
+	auto numberOfDiverseEmigrants = min(numberOfMigrants, diverseIndividuals.size());
+	partial_sort(eliteIndividuals.begin(), eliteIndividuals.begin()+numberOfEliteEmigrants, eliteIndividuals.end(), [](auto a, auto b) { return a->penalty < b->penalty; });
+	partial_sort(diverseIndividuals.begin(), diverseIndividuals.begin()+numberOfDiverseEmigrants, diverseIndividuals.end(), [](auto a, auto b) { return a->minimumDistance > b->minimumDistance; });
 
-	for (total_i = totalPopulationBegin, population_i = 0; total_i < totalPopulationEnd; total_i++, population_i++) {
-		population[population_i]  = totalPopulation[total_i];
+	vector<Solution> emigrants;
+	for (size_t i = 0; i < numberOfEliteEmigrants; i++) {
+		emigrants.push_back(eliteIndividuals[i]->solution);
+	}
+	for (size_t i = 0; i < numberOfDiverseEmigrants; i++) {
+		emigrants.push_back(diverseIndividuals[i]->solution);
+	}
+	return emigrants;
+}
+
+/*
+ * Moves the best immigrants into the candidate slots of the given thread populations and lets them compete for the reference sets
+ * through exchangeDiscardedIndividuals. Whatever loses goes back to the candidate slots, which keeps every id held by exactly one individual.
+ * Immigrants from searches on another graph are ignored
+ */
+void integrateImmigrants (const Graph &graph, vector<ScatterSearchPopulation<Individual>> &populations, size_t populationBegin, size_t populationEnd, vector<Solution> &immigrants, DistanceCache &distanceCache, const DistanceSketch &distanceSketch, const SolutionHasher &solutionHasher, thread_pile::slice_t availableThreads) {
+	immigrants.erase(remove_if(immigrants.begin(), immigrants.end(), [&](const Solution& immigrant) {
+		return immigrant.size() != graph.getNumberOfVertices() || any_of(immigrant.begin(), immigrant.end(), [&](TimeUnit timing) {
+			return timing < 0 || timing >= graph.getCycle();
+		});
+	}), immigrants.end());
+	if (immigrants.empty()) {
+		return;
 	}
 
+	vector<pair<TimeUnit, size_t>> immigrantPenalties;
+	for (size_t i = 0; i < immigrants.size(); i++) {
+		immigrantPenalties.emplace_back(graph.totalPenalty(immigrants[i]), i);
+	}
+	sort(immigrantPenalties.begin(), immigrantPenalties.end());
+
+	Population<Individual> arrivals;
+	auto immigrant = immigrantPenalties.begin();
+	for (auto population = populations.begin()+populationBegin; population < populations.begin()+populationEnd; population++) {
+		for (auto& candidate : population->candidate) {
+			if (immigrant == immigrantPenalties.end()) {
+				break;
+			}
+			distanceCache.invalidate(candidate.id);
+			candidate.solution = move(immigrants[immigrant->second]);
+			candidate.penalty = immigrant->first;
+			candidate.hash = solutionHasher.hash(candidate.solution);
+			distanceSketch.update(candidate);
+			arrivals.emplace_back(move(candidate));
+			immigrant++;
+		}
+	}
+
+	exchangeDiscardedIndividuals(graph, populations, populationBegin, populationEnd, arrivals, distanceCache, distanceSketch, availableThreads);
+
+	auto arrival = arrivals.begin();
+	for (auto population = populations.begin()+populationBegin; population < populations.begin()+populationEnd; population++) {
+		for (auto& candidate : population->candidate) {
+			if (arrival == arrivals.end()) {
+				return;
+			}
+			candidate = move(*arrival++);
+		}
+	}
 }
 
-Solution heuristic::parallel::scatterSearch (const Graph &graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads) {
-	if (elitePopulationSize%numberOfThreads != 0) {
-		throw invalid_argument("elitePopulationSize must be a multiple of the number of threads");
+// neighbor thread_i sends its emigrants to on its numberOfMigrations-th migration, or numberOfThreads when it has none
+unsigned migrationNeighbor (MigrationPolicy::Topology topology, unsigned thread_i, unsigned numberOfThreads, size_t numberOfMigrations, mt19937& randomEngine) {
+	if (numberOfThreads < 2) {
+		return numberOfThreads;
 	}
-	if ((elitePopulationSize+diversePopulationSize) % numberOfThreads != 0) {
-		throw invalid_argument("elitePopulationSize+diversePopulationSize must be a multiple of the number of threads");
+
+	switch (topology) {
+		case MigrationPolicy::RING:
+			return (thread_i+1)%numberOfThreads;
+		case MigrationPolicy::HYPERCUBE: {
+			// dimensions are taken in turn, partners beyond the last thread of an incomplete hypercube are skipped
+			unsigned dimensions = 0;
+			while ((1u << dimensions) < numberOfThreads) {
+				dimensions++;
+			}
+			unsigned partner = thread_i ^ (1u << (numberOfMigrations%dimensions));
+			return partner < numberOfThreads ? partner : numberOfThreads;
+		}
+		case MigrationPolicy::RANDOM_PAIRS: {
+			uniform_int_distribution<unsigned> partnerPicker(0, numberOfThreads-2);
+			auto partner = partnerPicker(randomEngine);
+			return partner < thread_i ? partner : partner+1;
+		}
+		default:
+			return numberOfThreads;
 	}
-	if (((elitePopulationSize+diversePopulationSize)/numberOfThreads)&1) {
-		throw invalid_argument("(elitePopulationSize+diversePopulationSize)/numberOfThreads must be an even number");
+}
+
+// copy of the graph allocated by the calling thread, which therefore lands on its node
+unique_ptr<const Graph> replicateGraph (const Graph &graph) {
+	auto adjacencyList = new unordered_map<Vertex, Weight>[graph.getNumberOfVertices()];
+	for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+		adjacencyList[v] = graph.neighborsOf(v);
 	}
-	if (brianKernighanCountBitsSet(numberOfThreads) != 1) {
-		throw invalid_argument("numberOfThreads must be a power of 2");
+	return make_unique<AdjacencyListGraph>(adjacencyList, graph.getNumberOfVertices(), graph.getCycle());
+}
+
+// exchanges leave the elite sets unsorted
+const Individual& bestEliteIndividual (vector<ScatterSearchPopulation<Individual>> &populations, size_t populationBegin, size_t populationEnd) {
+	const Individual* bestIndividual = &populations[populationBegin].elite[0];
+	for (auto population = populations.begin()+populationBegin; population < populations.begin()+populationEnd; population++) {
+		for (auto& individual : population->elite) {
+			if (individual.penalty < bestIndividual->penalty) {
+				bestIndividual = &individual;
+			}
+		}
+	}
+	return *bestIndividual;
+}
+
+struct Mailbox {
+	mutex lock;
+	vector<Solution> migrants;
+};
+
+Solution scatterSearchWithMigration (const Graph &graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const MigrationPolicy &migrationPolicy, const NumaPlacement &numaPlacement, const IslandMigration *migration, const ImprovementMethod &improvementMethod, const ConstructionMethod &constructionMethod, const ConstructionMethod &diverseConstructionMethod, size_t sketchSize) {
+	if (numberOfThreads < 1) {
+		throw invalid_argument("numberOfThreads must be greater than 0");
+	}
+	if ((elitePopulationSize+diversePopulationSize)&1) {
+		throw invalid_argument("elitePopulationSize+diversePopulationSize must be an even number");
+	}
+	if (elitePopulationSize < numberOfThreads) {
+		throw invalid_argument("elitePopulationSize must be at least the number of threads");
+	}
+	if ((elitePopulationSize+diversePopulationSize)/2 < numberOfThreads) {
+		throw invalid_argument("(elitePopulationSize+diversePopulationSize)/2 must be at least the number of threads");
+	}
+	if (numaPlacement.replicateGraph && !numaPlacement.pinThreads) {
+		throw invalid_argument("numaPlacement.replicateGraph requires numaPlacement.pinThreads");
 	}
 
 	Metrics metrics;
-#ifdef DELAYED_COMBINATION
-	atomic<bool> combinationSignal;
-#endif
 
 	thread_pile threads(numberOfThreads, 2);
+	using_threads(threads);
+	numa_topology topology;
+	if (numaPlacement.pinThreads) {
+		threads.pin(topology);
+	}
+
+	// the first thread of every node builds that node's replica
+	vector<unique_ptr<const Graph>> graphReplicas(topology.number_of_nodes());
+	vector<const Graph*> threadGraphs(numberOfThreads, &graph);
+	if (numaPlacement.replicateGraph && topology.number_of_nodes() > 1) {
+		for_each_thread {
+			auto node = threads.node_of(thread_i);
+			if (thread_i == 0 || threads.node_of(thread_i-1) != node) {
+				graphReplicas[node] = replicateGraph(graph);
+			}
+		} end_for_each_thread;
+		for (unsigned thread_i = 0; thread_i < numberOfThreads; thread_i++) {
+			threadGraphs[thread_i] = graphReplicas[threads.node_of(thread_i)].get();
+		}
+	}
 
 	StopFunction diverseLocalSearchStopFunction = stop_function_factory::numberOfIterations(localSearchIterations);
 	StopFunction eliteLocalSearchStopFunction = stop_function_factory::numberOfIterations(localSearchIterations*10);
 
 	Population<Individual> totalPopulation(scatterSearchPopulationSize(elitePopulationSize, diversePopulationSize));
+	DistanceCache distanceCache(totalPopulation.size());
+	DistanceSketch distanceSketch(graph, sketchSize);
+	SolutionHasher solutionHasher;
 	vector<ScatterSearchPopulation<Individual>> populations(numberOfThreads);
+	// kept across iterations, so each thread combines without allocating once its buffers have grown
+	vector<CombinationWorkspace> workspaces(numberOfThreads);
+	// sized below for the sub-population of each thread, so deduplicating never allocates during the search
+	vector<SolutionHashSet> populationHashes(numberOfThreads);
 
-#ifdef DELAYED_COMBINATION
-	vector<TimeUnit> minimumPenalty(numberOfThreads, numeric_limits<TimeUnit>::max());
-	vector<TimeUnit> minimumDistance(numberOfThreads, numeric_limits<TimeUnit>::max());
-#endif
-
-	const auto threadPopulationSize = totalPopulation.size()/numberOfThreads;
-	const auto threadElitePopulationSize = elitePopulationSize/numberOfThreads;
-	const auto threadDiversePopulationSize = diversePopulationSize/numberOfThreads;
+	const auto threadPopulationSizes = splitPopulation(elitePopulationSize, diversePopulationSize, numberOfThreads);
 
 	metrics.executionBegin = chrono::high_resolution_clock::now();
 
-	using_threads(threads);
-	for_each_thread {
-		auto threadPopulation = totalPopulation.slice(threadPopulationSize*thread_i, threadPopulationSize*(thread_i+1));
-		populations[thread_i] = ScatterSearchPopulation<Individual>(threadPopulation, threadElitePopulationSize, threadDiversePopulationSize);
-
-		for (auto& eliteIndividual : populations[thread_i].elite) {
-			auto initialSolution = localSearchHeuristic(graph, constructHeuristicSolution(graph), eliteLocalSearchStopFunction);
-			eliteIndividual = {
-				initialSolution,
-				graph.totalPenalty(initialSolution),
-				numeric_limits<TimeUnit>::max()
-			};
+	for (size_t i = 0; i < totalPopulation.size(); i++) {
+		totalPopulation[i].id = i;
+	}
+
+	vector<PopulationInitialization> initialization;
+	size_t threadPopulationBegin = 0;
+	for (unsigned thread_i = 0; thread_i < numberOfThreads; thread_i++) {
+		auto& size = threadPopulationSizes[thread_i];
+		auto threadPopulationSize = scatterSearchPopulationSize(size.elite, size.diverse);
+		auto threadPopulation = totalPopulation.slice(threadPopulationBegin, threadPopulationBegin+threadPopulationSize);
+		populations[thread_i] = ScatterSearchPopulation<Individual>(threadPopulation, size.elite, size.diverse);
+		populationHashes[thread_i].reserve(threadPopulationSize);
+		threadPopulationBegin += threadPopulationSize;
+		initialization.push_back({populations[thread_i].elite, eliteLocalSearchStopFunction, constructionMethod});
+	}
+	for (auto& population : populations) {
+		initialization.push_back({population.diverse, diverseLocalSearchStopFunction, diverseConstructionMethod});
+	}
+	thread_pile::slice_t allThreads = threads;
+	initializePopulation(graph, initialization, allThreads, improvementMethod);
+	if (numaPlacement.pinThreads) {
+		// initialization hands individuals to whichever thread is free, copying them moves their buffers to the node of the thread that owns them
+		for_each_thread {
+			for (auto& individual : populations[thread_i].total) {
+				individual = Individual(individual);
+			}
+		} end_for_each_thread;
+	}
+	for (auto& population : populations) {
+		for (auto& individual : population.reference) {
+			distanceSketch.update(individual);
+			individual.hash = solutionHasher.hash(individual.solution);
 		}
+	}
+
+	// one generation of the sub-population of thread_i, returning its best penalty
+	auto searchIteration = [&](unsigned thread_i) {
+		auto& population = populations[thread_i];
+		auto& workspace = workspaces[thread_i];
+		auto& hashes = populationHashes[thread_i];
+		auto& threadGraph = *threadGraphs[thread_i];
+
+		shuffle(population.reference.begin(), population.reference.end(), workspace.randomEngine);
 
-		for (auto& diverseIndividual : populations[thread_i].diverse) {
-			auto initialSolution = localSearchHeuristic(graph, constructHeuristicSolution(graph), diverseLocalSearchStopFunction);
-			diverseIndividual = {
-				initialSolution,
-				graph.totalPenalty(initialSolution),
-				numeric_limits<TimeUnit>::max()
-			};
+		hashes.clear();
+		for (auto& individual : population.reference) {
+			hashes.insert(individual.hash);
 		}
-	} end_for_each_thread;
 
-	metrics.numberOfIterations = 0;
-	metrics.numberOfIterationsWithoutImprovement = 0;
-	metrics.penalty = numeric_limits<TimeUnit>::max();
-	while (stopFunction(metrics)) {
+		for (size_t i = 0; i < population.candidate.size(); i++) {
 
-		for_each_thread {
-			auto& population = populations[thread_i];
+			auto& individual1 = population.reference[i*2];
+			auto& individual2 = population.reference[i*2+1];
 
-			random_device seeder;
-			mt19937 randomEngine(seeder());
+			distanceCache.invalidate(population.candidate[i].id);
+			combinationMethod(graph, individual1.solution, individual2.solution, population.candidate[i].solution, workspace);
+			hashes.insert(solutionHasher.mutateUntilUnique(threadGraph, population.candidate[i].solution, solutionHasher.hash(population.candidate[i].solution), hashes, workspace.randomEngine));
+			improvementMethod.improve(threadGraph, population.candidate[i].solution, diverseLocalSearchStopFunction);
+			population.candidate[i].penalty = threadGraph.totalPenalty(population.candidate[i].solution);
+			population.candidate[i].hash = solutionHasher.hash(population.candidate[i].solution);
+			distanceSketch.update(population.candidate[i]);
 
-			shuffle(populations[thread_i].reference.begin(), populations[thread_i].reference.end(), randomEngine);
+		}
 
-			for (size_t i = 0; i < populations[thread_i].candidate.size(); i++) {
+		sort(population.total.begin(), population.total.end(), lowestPenalty);
+		auto bestPenalty = population.elite[0].penalty;
 
-				auto& individual1 = populations[thread_i].reference[i*2];
-				auto& individual2 = populations[thread_i].reference[i*2+1];
+		diversify(graph, population, distanceCache, distanceSketch);
+		return bestPenalty;
+	};
 
-				population.candidate[i].solution = combinationMethod(graph, individual1.solution, individual2.solution);
-				population.candidate[i].solution = localSearchHeuristic(graph, population.candidate[i].solution, diverseLocalSearchStopFunction);
-				population.candidate[i].penalty = graph.totalPenalty(populations[thread_i].candidate[i].solution);
+	auto migrateIsland = [&](size_t populationBegin, size_t populationEnd, thread_pile::slice_t availableThreads) {
+		migration->transport->send(collectEmigrants(populations, populationBegin, populationEnd, migration->numberOfMigrants));
+		auto immigrants = migration->transport->receive();
+		integrateImmigrants(graph, populations, populationBegin, populationEnd, immigrants, distanceCache, distanceSketch, solutionHasher, availableThreads);
+	};
 
-			}
+	// initialization is the longest stretch without a check, so the first one already reports the best elite
+	auto& initialBestIndividual = bestEliteIndividual(populations, 0, numberOfThreads);
+	metrics.numberOfIterations = 0;
+	metrics.numberOfIterationsWithoutImprovement = 0;
+	metrics.penalty = initialBestIndividual.penalty;
+	metrics.solution = &initialBestIndividual.solution;
 
-			sort(population.total.begin(), population.total.end(), lowestPenalty);
+	if (migrationPolicy.topology == MigrationPolicy::TREE) {
+		vector<TimeUnit> bestPenalty(numberOfThreads);
+		size_t iterationsSinceExchange = 0;
 
-		#ifdef DELAYED_COMBINATION
-			if(population.elite[0].penalty < minimumPenalty[thread_i]) {
-				combinationSignal.store(true);
-				minimumPenalty[thread_i] = population.elite[0].penalty;
-			}
-		#endif
+		while (stopFunction(metrics)) {
 
-		#ifdef DELAYED_COMBINATION
-			auto iterationMinimumDistance =
-		#endif
-				diversify(graph, populations[thread_i]);
+			for_each_thread {
+				bestPenalty[thread_i] = searchIteration(thread_i);
+			} end_for_each_thread;
 
-		#ifdef DELAYED_COMBINATION
-			if (iterationMinimumDistance < minimumDistance[thread_i]) {
-				combinationSignal.store(true);
-				minimumDistance[thread_i] = iterationMinimumDistance;
+			auto iterationPenalty = *min_element(bestPenalty.begin(), bestPenalty.end());
+			if (iterationPenalty < metrics.penalty) {
+				metrics.penalty = iterationPenalty;
+				metrics.numberOfIterationsWithoutImprovement = 0;
+			} else {
+				metrics.numberOfIterationsWithoutImprovement++;
 			}
-		#endif
-
-			if	(
-				thread_i == 0
-			#ifdef DELAYED_COMBINATION
-			   	&& combinationSignal.load()
-			#endif
-				) {
-				bottomUpTreeDiversify(graph, populations, 0, numberOfThreads, elitePopulationSize, diversePopulationSize, threads);
-			#ifdef DELAYED_COMBINATION
-				combinationSignal.store(false);
-			#endif
+			metrics.numberOfIterations++;
+			iterationsSinceExchange++;
+
+			// run after every thread has finished combining, otherwise the exchange could read candidates that are still being written
+			if (migrationPolicy.isDue(iterationsSinceExchange, metrics.numberOfIterationsWithoutImprovement)) {
+				auto discardedPopulation = bottomUpTreeDiversify(graph, populations, 0, numberOfThreads, elitePopulationSize, diversePopulationSize, distanceCache, distanceSketch, threads);
+				// the discarded individuals go back to the candidate slots they were moved out of, so every id stays held by exactly one individual
+				auto discardedIndividual = discardedPopulation.begin();
+				for (auto& population : populations) {
+					for (auto& candidate : population.candidate) {
+						candidate = move(*discardedIndividual++);
+					}
+				}
+				iterationsSinceExchange = 0;
 			}
 
-		} end_for_each_thread;
+			if (migration && metrics.numberOfIterations%migration->interval == 0) {
+				migrateIsland(0, numberOfThreads, threads.depth(1).slice(0, numberOfThreads));
+			}
 
-		metrics.numberOfIterations++;
+			// exchanges and migrations move individuals around, and immigrants may beat every thread's own best
+			auto& bestIndividual = bestEliteIndividual(populations, 0, numberOfThreads);
+			if (bestIndividual.penalty < metrics.penalty) {
+				metrics.penalty = bestIndividual.penalty;
+				metrics.numberOfIterationsWithoutImprovement = 0;
+			}
+			metrics.solution = &bestIndividual.solution;
+
+		}
+	} else {
+		vector<Mailbox> mailboxes(numberOfThreads);
+		mutex metricsLock;
+		atomic<bool> stopSignal(!stopFunction(metrics));
+		size_t numberOfThreadIterations = 0, lastImprovement = 0;
 
+		// every thread searches its own sub-population without waiting for the others, posting emigrants to its neighbors' mailboxes as it goes
+		for_each_thread {
+			auto availableThreads = threads.depth(1).slice(thread_i, thread_i+1);
+			TimeUnit threadPenalty = numeric_limits<TimeUnit>::max();
+			size_t iterations = 0, iterationsSinceMigration = 0, iterationsWithoutImprovement = 0, numberOfMigrations = 0;
+
+			while (!stopSignal.load()) {
+				auto iterationPenalty = searchIteration(thread_i);
+				iterations++;
+				iterationsSinceMigration++;
+				if (iterationPenalty < threadPenalty) {
+					threadPenalty = iterationPenalty;
+					iterationsWithoutImprovement = 0;
+				} else {
+					iterationsWithoutImprovement++;
+				}
+
+				if (migrationPolicy.isDue(iterationsSinceMigration, iterationsWithoutImprovement)) {
+					auto neighbor = migrationNeighbor(migrationPolicy.topology, thread_i, numberOfThreads, numberOfMigrations++, workspaces[thread_i].randomEngine);
+					if (neighbor < numberOfThreads) {
+						auto emigrants = collectEmigrants(populations, thread_i, thread_i+1, migrationPolicy.numberOfMigrants);
+						lock_guard<mutex> guard(mailboxes[neighbor].lock);
+						for (auto& emigrant : emigrants) {
+							mailboxes[neighbor].migrants.push_back(move(emigrant));
+						}
+					}
+					iterationsSinceMigration = 0;
+				}
+
+				vector<Solution> immigrants;
+				{
+					lock_guard<mutex> guard(mailboxes[thread_i].lock);
+					immigrants.swap(mailboxes[thread_i].migrants);
+				}
+				integrateImmigrants(graph, populations, thread_i, thread_i+1, immigrants, distanceCache, distanceSketch, solutionHasher, availableThreads);
+
+				// other islands only meet the sub-population of the first thread
+				if (migration && thread_i == 0 && iterations%migration->interval == 0) {
+					migrateIsland(0, 1, availableThreads);
+				}
+
+				// immigrants may have beaten the best individual of the iteration
+				auto& bestIndividual = bestEliteIndividual(populations, thread_i, thread_i+1);
+				threadPenalty = min(threadPenalty, bestIndividual.penalty);
+
+				lock_guard<mutex> guard(metricsLock);
+				numberOfThreadIterations++;
+				// other threads keep changing their populations, so only the calling thread's best individual can be shown to the stop function
+				metrics.solution = nullptr;
+				if (threadPenalty < metrics.penalty) {
+					metrics.penalty = threadPenalty;
+					metrics.solution = &bestIndividual.solution;
+					lastImprovement = numberOfThreadIterations;
+				}
+				// stop functions see one iteration per numberOfThreads thread iterations, as in the synchronous search
+				metrics.numberOfIterations = numberOfThreadIterations/numberOfThreads;
+				metrics.numberOfIterationsWithoutImprovement = (numberOfThreadIterations-lastImprovement)/numberOfThreads;
+				if (!stopFunction(metrics)) {
+					stopSignal.store(true);
+				}
+			}
+		} end_for_each_thread;
 	}
 
-	auto bestIndividual = populations[0].elite.begin();
-	for (auto& population : populations) {
-		if (population.elite[0].penalty < bestIndividual->penalty) {
-			bestIndividual = population.elite.begin();
-		}
+	return bestEliteIndividual(populations, 0, numberOfThreads).solution;
+}
+
+Solution heuristic::parallel::scatterSearch (const Graph &graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const ImprovementMethod &improvementMethod, const ConstructionMethod &constructionMethod, const ConstructionMethod &diverseConstructionMethod, size_t sketchSize, const MigrationPolicy &migrationPolicy, const NumaPlacement &numaPlacement) {
+	return scatterSearchWithMigration(graph, elitePopulationSize, diversePopulationSize, localSearchIterations, stopFunction, combinationMethod, numberOfThreads, migrationPolicy, numaPlacement, nullptr, improvementMethod, constructionMethod, diverseConstructionMethod, sketchSize);
+}
+
+Solution heuristic::parallel::islandScatterSearch (const Graph &graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const IslandMigration &migration, const ImprovementMethod &improvementMethod, const ConstructionMethod &constructionMethod, const ConstructionMethod &diverseConstructionMethod, size_t sketchSize, const MigrationPolicy &migrationPolicy, const NumaPlacement &numaPlacement) {
+	if (!migration.transport) {
+		throw invalid_argument("migration.transport must not be empty");
+	}
+	if (migration.interval < 1) {
+		throw invalid_argument("migration.interval must be greater than 0");
 	}
-	return bestIndividual->solution;
+	return scatterSearchWithMigration(graph, elitePopulationSize, diversePopulationSize, localSearchIterations, stopFunction, combinationMethod, numberOfThreads, migrationPolicy, numaPlacement, &migration, improvementMethod, constructionMethod, diverseConstructionMethod, sketchSize);
 }
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include "../parallel/reusable_thread.h"
+#include "heuristic.h"
+#include <vector>
+
+namespace heuristic {
+
+	// internals of the parallel searches, kept apart from heuristic.h so that it does not depend on thread piles
+	namespace parallel {
+
+		// same as the initializePopulation of heuristic.h, on threads the caller already has
+		void initializePopulation (const traffic::Graph& graph, const std::vector<PopulationInitialization> &slices, ::parallel::thread_pile::slice_t &availableThreads, const ImprovementMethod &improvementMethod);
+
+		/*
+		 * Offers the discarded individuals to each population in turn. The best discarded individual, kept on top of a heap keyed on penalty,
+		 * replaces every elite individual worse than it. The diverse set is then refilled greedily with whichever is farther from the individuals
+		 * already selected: the best remaining diverse individual, from a heap keyed on minimum distance, or the farthest discarded one.
+		 * With exact distances, those between the reference set and the discarded individuals are computed up front in one parallel pass over tiles
+		 * of both, so the selection itself mostly reads the distance cache.
+		 * The farthest discarded individual is found in the same pass that folds the distance to each new selection into their keys
+		 */
+		void exchangeDiscardedIndividuals (
+			const traffic::Graph &graph,
+			std::vector<ScatterSearchPopulation<Individual>> &populations,
+			size_t populationOffsetBegin,
+			size_t populationOffsetEnd,
+			PopulationInterface<Individual>& discardedPopulation,
+			DistanceCache &distanceCache,
+			const DistanceSketch &distanceSketch,
+			::parallel::thread_pile::slice_t &availableThreads
+		);
+
+	}
+
+}
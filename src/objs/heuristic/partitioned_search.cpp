@@ -0,0 +1,161 @@
+#include "heuristic.h"
+#include "../partition/partition.h"
+#include "../parallel/macros.h"
+#include "../parallel/reusable_thread.h"
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <algorithm>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+using namespace ::parallel;
+
+TimeUnit circularDistance (TimeUnit difference, TimeUnit cycle) {
+	difference = ((difference%cycle) + cycle)%cycle;
+	return min(difference, cycle - difference);
+}
+
+/*
+ * A solution keeps its penalty when all its timings are shifted by the same amount, so every connected piece a part was solved as
+ * is free to be shifted. Pieces are placed in breadth-first order over the cut edges, starting from the largest one,
+ * each with the shift that minimizes the penalty of its cut edges to the pieces already placed
+ */
+void alignPieces (const Graph& graph, Solution& solution, const partition::Partition& parts, const vector<bool>& isSolved, vector<bool>& isPlaced) {
+	Vertex nVertices = graph.getNumberOfVertices();
+	TimeUnit cycle = graph.getCycle();
+	Vertex noPiece = nVertices;
+	vector<Vertex> pieceOf(nVertices, noPiece);
+	vector<vector<Vertex>> pieces;
+	queue<Vertex> visitQueue;
+	vector<TimeUnit> shiftPenalty(cycle);
+
+	for (Vertex root = 0; root < nVertices; root++) {
+		if (!isSolved[root] || pieceOf[root] != noPiece) {
+			continue;
+		}
+		pieces.emplace_back();
+		pieceOf[root] = pieces.size()-1;
+		visitQueue.push(root);
+		while (!visitQueue.empty()) {
+			auto vertex = visitQueue.front();
+			visitQueue.pop();
+			pieces.back().push_back(vertex);
+			for (auto& neighbor : graph.neighborsOf(vertex)) {
+				if (isSolved[neighbor.first] && pieceOf[neighbor.first] == noPiece && parts[neighbor.first] == parts[vertex]) {
+					pieceOf[neighbor.first] = pieceOf[root];
+					visitQueue.push(neighbor.first);
+				}
+			}
+		}
+	}
+
+	vector<Vertex> pieceOrder(pieces.size());
+	vector<bool> wasQueued(pieces.size(), false);
+	for (Vertex p = 0; p < pieces.size(); p++) {
+		pieceOrder[p] = p;
+	}
+	sort(pieceOrder.begin(), pieceOrder.end(), [&](Vertex a, Vertex b) { return pieces[a].size() > pieces[b].size(); });
+
+	for (auto firstPiece : pieceOrder) {
+		if (wasQueued[firstPiece]) {
+			continue;
+		}
+		wasQueued[firstPiece] = true;
+		visitQueue.push(firstPiece);
+
+		while (!visitQueue.empty()) {
+			auto piece = visitQueue.front();
+			visitQueue.pop();
+
+			fill(shiftPenalty.begin(), shiftPenalty.end(), 0);
+			for (auto vertex : pieces[piece]) {
+				for (auto& neighbor : graph.neighborsOf(vertex)) {
+					auto neighborPiece = pieceOf[neighbor.first];
+					if (isPlaced[neighbor.first]) {
+						TimeUnit weight = neighbor.second%cycle;
+						for (TimeUnit shift = 0; shift < cycle; shift++) {
+							TimeUnit timing = solution[vertex] + shift;
+							shiftPenalty[shift] += circularDistance(solution[neighbor.first] - weight - timing, cycle) + circularDistance(timing - weight - solution[neighbor.first], cycle);
+						}
+					} else if (neighborPiece != noPiece && !wasQueued[neighborPiece]) {
+						wasQueued[neighborPiece] = true;
+						visitQueue.push(neighborPiece);
+					}
+				}
+			}
+
+			TimeUnit bestShift = min_element(shiftPenalty.begin(), shiftPenalty.end()) - shiftPenalty.begin();
+			for (auto vertex : pieces[piece]) {
+				solution[vertex] = (solution[vertex] + bestShift)%cycle;
+				isPlaced[vertex] = true;
+			}
+		}
+	}
+}
+
+Solution heuristic::parallel::partitionedSearch (const Graph& graph, unsigned numberOfParts, const ConstructionMethod& subproblemMethod, unsigned numberOfThreads) {
+	if (numberOfThreads < 1) {
+		throw invalid_argument("numberOfThreads must be greater than 0");
+	}
+
+	Vertex nVertices = graph.getNumberOfVertices();
+	auto parts = partition::multilevelPartition(graph, numberOfParts);
+	vector<vector<Vertex>> subproblems(numberOfParts);
+	vector<bool> isSolved(nVertices, false);
+	vector<bool> isPlaced(nVertices, false);
+	vector<Vertex> cutVertices;
+	Solution solution(nVertices, 0);
+
+	// vertices without a neighbor in their own part are left out of the subproblems, since they would be isolated there
+	for (Vertex v = 0; v < nVertices; v++) {
+		bool hasInternalEdge = false, hasCutEdge = false;
+		for (auto& neighbor : graph.neighborsOf(v)) {
+			if (parts[neighbor.first] == parts[v]) {
+				hasInternalEdge = true;
+			} else {
+				hasCutEdge = true;
+			}
+		}
+		if (hasInternalEdge) {
+			subproblems[parts[v]].push_back(v);
+			isSolved[v] = true;
+		}
+		if (hasCutEdge || !hasInternalEdge) {
+			cutVertices.push_back(v);
+		}
+	}
+
+	vector<unsigned> partOrder(numberOfParts);
+	for (unsigned p = 0; p < numberOfParts; p++) {
+		partOrder[p] = p;
+	}
+	sort(partOrder.begin(), partOrder.end(), [&](unsigned a, unsigned b) { return subproblems[a].size() > subproblems[b].size(); });
+
+	thread_pile threads(usable_threads(numberOfParts, numberOfThreads));
+	using_threads(threads);
+	dynamic_parallel_for (partOrder.begin(), partOrder.end()) {
+		auto& vertices = subproblems[*i];
+		if (vertices.empty()) {
+			continue;
+		}
+		unique_ptr<Graph> subgraph(partition::buildInducedSubgraph(graph, vertices));
+		auto subproblemSolution = subproblemMethod(*subgraph);
+		for (Vertex j = 0; j < vertices.size(); j++) {
+			solution[vertices[j]] = subproblemSolution[j];
+		}
+	} end_dynamic_parallel_for;
+
+	alignPieces(graph, solution, parts, isSolved, isPlaced);
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		if (!isPlaced[v]) {
+			solution[v] = optimalTiming(graph, v, solution, isPlaced).timing;
+			isPlaced[v] = true;
+		}
+	}
+
+	return activeVertexLocalSearch(graph, solution, cutVertices);
+}
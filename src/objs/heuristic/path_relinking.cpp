@@ -0,0 +1,172 @@
+#include "heuristic.h"
+#include "../parallel/macros.h"
+#include "../parallel/reusable_thread.h"
+
+#include <vector>
+#include <tuple>
+#include <memory>
+#include <random>
+#include <algorithm>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+using namespace ::parallel;
+
+/*
+ * Moves the vertices where the initiating solution differs from the guiding one to their guiding timings, one at a time, and leaves in path the best
+ * solution strictly between both parents. Moves only change the penalty of the edges around the moved vertex, so each is evaluated in O(degree).
+ * Without a random engine the move with the lowest penalty is always taken next, kept in a heap whose entries are refreshed as neighbors move,
+ * otherwise the vertices are moved in random order. Every buffer of path is reused, so walks on graphs no larger than earlier ones allocate nothing
+ */
+void walkPath (const Graph& graph, const Solution& initiatingSolution, const Solution& guidingSolution, mt19937* randomEngine, RelinkingPath& path) {
+	typedef tuple<TimeUnit, Vertex, unsigned> Move;
+	Vertex nVertices = graph.getNumberOfVertices();
+	TimeUnit cycle = graph.getCycle();
+	auto& solution = path.solution;
+	auto& differingVertices = path.differingVertices;
+	auto& isDiffering = path.isDiffering;
+	auto& moves = path.moves;
+
+	solution = initiatingSolution;
+	differingVertices.clear();
+	isDiffering.assign(nVertices, false);
+	moves.clear();
+
+	auto circularDistance = [cycle](TimeUnit difference) {
+		difference = ((difference%cycle) + cycle)%cycle;
+		return min(difference, cycle - difference);
+	};
+	auto penaltyAt = [&](Vertex vertex, TimeUnit timing) {
+		TimeUnit vertexPenalty = 0;
+		for (auto& neighbor : graph.neighborsOf(vertex)) {
+			vertexPenalty += circularDistance(solution[neighbor.first] - neighbor.second - timing) + circularDistance(timing - neighbor.second - solution[neighbor.first]);
+		}
+		return vertexPenalty;
+	};
+	auto moveDelta = [&](Vertex vertex) {
+		return penaltyAt(vertex, guidingSolution[vertex]) - penaltyAt(vertex, solution[vertex]);
+	};
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		if (initiatingSolution[v] != guidingSolution[v]) {
+			differingVertices.push_back(v);
+			isDiffering[v] = true;
+		}
+	}
+
+	TimeUnit penalty = graph.totalPenalty(initiatingSolution);
+	if (differingVertices.size() < 2) {
+		path.penalty = penalty;
+		return;
+	}
+
+	TimeUnit bestPenalty = numeric_limits<TimeUnit>::max();
+	size_t bestNumberOfMoves = 0;
+	auto applyMove = [&](Vertex vertex, TimeUnit delta) {
+		penalty += delta;
+		solution[vertex] = guidingSolution[vertex];
+		isDiffering[vertex] = false;
+		moves.push_back(vertex);
+		if (penalty < bestPenalty) {
+			bestPenalty = penalty;
+			bestNumberOfMoves = moves.size();
+		}
+	};
+
+	// the last move would reach the guiding solution itself
+	size_t numberOfMoves = differingVertices.size()-1;
+
+	if (randomEngine) {
+		shuffle(differingVertices.begin(), differingVertices.end(), *randomEngine);
+		for (size_t i = 0; i < numberOfMoves; i++) {
+			applyMove(differingVertices[i], moveDelta(differingVertices[i]));
+		}
+	} else {
+		auto& version = path.version;
+		auto& bestMoves = path.bestMoves;
+		version.assign(nVertices, 0);
+		bestMoves.clear();
+		for (auto v : differingVertices) {
+			bestMoves.emplace_back(moveDelta(v), v, 0);
+		}
+		make_heap(bestMoves.begin(), bestMoves.end(), greater<Move>());
+
+		while (moves.size() < numberOfMoves) {
+			pop_heap(bestMoves.begin(), bestMoves.end(), greater<Move>());
+			auto [delta, vertex, moveVersion] = bestMoves.back();
+			bestMoves.pop_back();
+			if (!isDiffering[vertex] || moveVersion != version[vertex]) {
+				continue;
+			}
+
+			applyMove(vertex, delta);
+			for (auto& neighbor : graph.neighborsOf(vertex)) {
+				if (isDiffering[neighbor.first]) {
+					version[neighbor.first]++;
+					bestMoves.emplace_back(moveDelta(neighbor.first), neighbor.first, version[neighbor.first]);
+					push_heap(bestMoves.begin(), bestMoves.end(), greater<Move>());
+				}
+			}
+		}
+	}
+
+	solution = initiatingSolution;
+	for (size_t i = 0; i < bestNumberOfMoves; i++) {
+		solution[moves[i]] = guidingSolution[moves[i]];
+	}
+	path.penalty = bestPenalty;
+}
+
+Solution heuristic::pathRelinking (const Graph& graph, const Solution& initiatingSolution, const Solution& guidingSolution) {
+	RelinkingPath path;
+	walkPath(graph, initiatingSolution, guidingSolution, nullptr, path);
+	return move(path.solution);
+}
+
+CombinationMethod combination_method_factory::pathRelinking (unsigned numberOfPaths, unsigned numberOfThreads) {
+	if (numberOfPaths < 1) {
+		throw invalid_argument("numberOfPaths must be greater than 0");
+	}
+	if (numberOfThreads < 1) {
+		throw invalid_argument("numberOfThreads must be greater than 0");
+	}
+
+	// shared by every copy of the combination method, since scatter searches copy it into each of their threads
+	shared_ptr<thread_pile> threads;
+	if (numberOfPaths > 1 && numberOfThreads > 1) {
+		threads = make_shared<thread_pile>(min(numberOfPaths, numberOfThreads));
+	}
+
+	return [numberOfPaths, threads](const Graph& graph, const Solution& a, const Solution& b, Solution& output, CombinationWorkspace& workspace) {
+		auto& paths = workspace.relinkingPaths;
+		if (paths.size() < numberOfPaths) {
+			paths.resize(numberOfPaths);
+		}
+		for (unsigned path = 0; path < numberOfPaths; path++) {
+			paths[path].seed = workspace.randomEngine();
+		}
+
+		// the first two paths are greedy walks in both directions, any further path walks in random order
+		auto relink = [&](unsigned path) {
+			mt19937 randomEngine(paths[path].seed);
+			auto& initiatingSolution = path%2 == 0 ? a : b;
+			auto& guidingSolution = path%2 == 0 ? b : a;
+			walkPath(graph, initiatingSolution, guidingSolution, path < 2 ? nullptr : &randomEngine, paths[path]);
+		};
+
+		if (threads) {
+			using_threads(*threads);
+			dynamic_parallel_for (paths.begin(), paths.begin()+numberOfPaths) {
+				relink(i - paths.begin());
+			} end_dynamic_parallel_for;
+		} else {
+			for (unsigned path = 0; path < numberOfPaths; path++) {
+				relink(path);
+			}
+		}
+
+		// swapped rather than copied, the output's previous buffer becoming the working copy of that path on the next call
+		output.swap(min_element(paths.begin(), paths.begin()+numberOfPaths, [](const auto& x, const auto& y) { return x.penalty < y.penalty; })->solution);
+	};
+}
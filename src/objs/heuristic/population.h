@@ -4,13 +4,23 @@
 #include <vector>
 #include <list>
 #include <mutex>
+#include <cstdint>
 
 namespace heuristic {
 
 	struct Individual {
 		traffic::Solution solution;
 		traffic::TimeUnit penalty;
+		// distance to the nearest individual of the selected set. With a DistanceSketch it may be an exact refinement of estimatedMinimumDistance
 		traffic::TimeUnit minimumDistance;
+		// sketched distance to the nearest selected individual, exact when distances are. Never holds exact refinements, so fresh estimates can be folded into it
+		traffic::TimeUnit estimatedMinimumDistance;
+		// identity within its population, which moves along with the individual and keys its cached distances
+		size_t id;
+		// timings at the vertices sampled by a DistanceSketch, empty when distances are exact
+		std::vector<uint16_t> sketch;
+		// SolutionHasher hash of the solution
+		uint64_t hash;
 	};
 
 	template<typename T>
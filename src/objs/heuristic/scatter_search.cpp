@@ -7,83 +7,150 @@ using namespace traffic;
 using namespace std;
 using namespace heuristic;
 
-TimeUnit heuristic::diversify (const Graph &graph, ScatterSearchPopulation<Individual> &population) {
+typedef vector<Individual>::iterator IndividualIterator;
+
+IndividualIterator greatestMinimumDistance (IndividualIterator begin, IndividualIterator end) {
+	return max_element(begin, end, [](const Individual& a, const Individual& b) { return a.minimumDistance < b.minimumDistance; });
+}
+
+/*
+ * Max-min selection: the diverse population is filled one individual at a time with the battling individual farthest from every individual
+ * already selected. distanceBetween keeps the minimum distance of each battling individual up to date, and choose picks among them
+ */
+template<typename DistanceFunction, typename ChoiceFunction>
+TimeUnit diversifyWith (ScatterSearchPopulation<Individual> &population, DistanceFunction distanceBetween, ChoiceFunction choose) {
 	auto nextGenerationBegin = population.elite.begin();
 	auto nextGenerationEnd = population.elite.end();
 	auto battlingPopulationBegin = population.diverse.begin();
 	auto battlingPopulationEnd = population.candidate.end();
 	TimeUnit infinity = numeric_limits<TimeUnit>::max();
-	TimeUnit minusInfinity = numeric_limits<TimeUnit>::min();
 	TimeUnit currentDistance;
-	TimeUnit greatestMinimumDistance;
 	TimeUnit lowestDistance = numeric_limits<TimeUnit>::max();
-	decltype(battlingPopulationBegin) chosenIndividual;
-	decltype(battlingPopulationBegin) nextChosenIndividual;
 
-	greatestMinimumDistance = minusInfinity;
-	for (auto it = battlingPopulationBegin; it != battlingPopulationEnd; it++) {
+	auto updateMinimumDistance = [&](Individual& battlingIndividual, const Individual& selectedIndividual) {
+		currentDistance = distanceBetween(battlingIndividual, selectedIndividual);
+		if (currentDistance < lowestDistance) {
+			lowestDistance = currentDistance;
+		}
+		if (currentDistance < battlingIndividual.estimatedMinimumDistance) {
+			battlingIndividual.estimatedMinimumDistance = currentDistance;
+		}
+		battlingIndividual.minimumDistance = battlingIndividual.estimatedMinimumDistance;
+	};
 
+	for (auto it = battlingPopulationBegin; it != battlingPopulationEnd; it++) {
 		it->minimumDistance = infinity;
+		it->estimatedMinimumDistance = infinity;
 		for (auto jt = nextGenerationBegin; jt < nextGenerationEnd; jt++) {
-			currentDistance = distance(graph, it->solution, jt->solution);
-			if (currentDistance < lowestDistance) {
-				lowestDistance = currentDistance;
-			}
-			if (currentDistance < it->minimumDistance) {
-				it->minimumDistance = currentDistance;
-			}
-		}
-
-		if (it->minimumDistance > greatestMinimumDistance) {
-			greatestMinimumDistance = it->minimumDistance;
-			chosenIndividual = it;
+			updateMinimumDistance(*it, *jt);
 		}
 	}
 
-	swap(*chosenIndividual, *nextGenerationEnd);
-	nextGenerationEnd++;
-	battlingPopulationBegin++;
-
 	while (nextGenerationEnd != population.diverse.end()) {
-
-		greatestMinimumDistance = minusInfinity;
-		for (auto it = battlingPopulationBegin; it != battlingPopulationEnd; it++) {
-			currentDistance = distance(graph, chosenIndividual->solution, it->solution);
-			if (currentDistance < lowestDistance) {
-				lowestDistance = currentDistance;
-			}
-			if (currentDistance < it->minimumDistance) {
-				it->minimumDistance = currentDistance;
-			}
-			if (it->minimumDistance > greatestMinimumDistance) {
-				greatestMinimumDistance = it->minimumDistance;
-				nextChosenIndividual = it;
-			}
-		}
-
-		chosenIndividual = nextChosenIndividual;
+		auto chosenIndividual = choose(battlingPopulationBegin, battlingPopulationEnd, nextGenerationBegin, nextGenerationEnd);
 
 		swap(*chosenIndividual, *nextGenerationEnd);
 		nextGenerationEnd++;
 		battlingPopulationBegin++;
 
+		if (nextGenerationEnd == population.diverse.end()) {
+			break;
+		}
+		for (auto it = battlingPopulationBegin; it != battlingPopulationEnd; it++) {
+			updateMinimumDistance(*it, *(nextGenerationEnd-1));
+		}
 	}
 
 	return lowestDistance;
 }
 
-Solution heuristic::scatterSearch (const Graph &graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod) {
+TimeUnit heuristic::diversify (const Graph &graph, ScatterSearchPopulation<Individual> &population) {
+	return diversifyWith(population, [&](const Individual& a, const Individual& b) {
+		return distance(graph, a.solution, b.solution);
+	}, [](IndividualIterator begin, IndividualIterator end, IndividualIterator, IndividualIterator) {
+		return greatestMinimumDistance(begin, end);
+	});
+}
+
+TimeUnit heuristic::diversify (const Graph &graph, ScatterSearchPopulation<Individual> &population, DistanceCache &distanceCache) {
+	return diversifyWith(population, [&](const Individual& a, const Individual& b) {
+		return distanceCache.distance(graph, a, b);
+	}, [](IndividualIterator begin, IndividualIterator end, IndividualIterator, IndividualIterator) {
+		return greatestMinimumDistance(begin, end);
+	});
+}
+
+TimeUnit heuristic::refineMinimumDistance (const Graph &graph, const Individual &individual, IndividualIterator selectedBegin, IndividualIterator selectedEnd, DistanceCache &distanceCache, const DistanceSketch &distanceSketch) {
+	if (selectedBegin >= selectedEnd) {
+		return individual.estimatedMinimumDistance;
+	}
+
+	// the individual nearest by estimate is always measured, so the result is exact even when every estimate is off by more than the tolerance
+	auto nearestEstimate = selectedBegin;
+	TimeUnit lowestEstimate = numeric_limits<TimeUnit>::max();
+	for (auto it = selectedBegin; it < selectedEnd; it++) {
+		auto estimate = distanceSketch.estimatedDistance(individual, *it);
+		if (estimate < lowestEstimate) {
+			lowestEstimate = estimate;
+			nearestEstimate = it;
+		}
+	}
+
+	TimeUnit exactMinimumDistance = distanceCache.distance(graph, individual, *nearestEstimate);
+	for (auto it = selectedBegin; it < selectedEnd; it++) {
+		if (it != nearestEstimate && distanceSketch.estimatedDistance(individual, *it) <= lowestEstimate*(1+DistanceSketch::CLOSE_CALL_TOLERANCE)) {
+			exactMinimumDistance = min(exactMinimumDistance, distanceCache.distance(graph, individual, *it));
+		}
+	}
+	return exactMinimumDistance;
+}
+
+TimeUnit heuristic::diversify (const Graph &graph, ScatterSearchPopulation<Individual> &population, DistanceCache &distanceCache, const DistanceSketch &distanceSketch) {
+	if (distanceSketch.isExact()) {
+		return diversify(graph, population, distanceCache);
+	}
+
+	return diversifyWith(population, [&](const Individual& a, const Individual& b) {
+		return distanceSketch.estimatedDistance(a, b);
+	}, [&](IndividualIterator begin, IndividualIterator end, IndividualIterator selectedBegin, IndividualIterator selectedEnd) {
+		auto chosenIndividual = greatestMinimumDistance(begin, end);
+		TimeUnit closeCallThreshold = chosenIndividual->minimumDistance*(1-DistanceSketch::CLOSE_CALL_TOLERANCE);
+		TimeUnit greatestExactDistance = -1;
+
+		// only battling individuals whose estimate is close to the best one are compared exactly
+		for (auto it = begin; it != end; it++) {
+			if (it->minimumDistance >= closeCallThreshold) {
+				auto exactMinimumDistance = refineMinimumDistance(graph, *it, selectedBegin, selectedEnd, distanceCache, distanceSketch);
+				if (exactMinimumDistance > greatestExactDistance) {
+					greatestExactDistance = exactMinimumDistance;
+					chosenIndividual = it;
+				}
+			}
+		}
+
+		chosenIndividual->minimumDistance = greatestExactDistance;
+		return chosenIndividual;
+	});
+}
+
+Solution heuristic::scatterSearch (const Graph &graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, const ImprovementMethod &improvementMethod, const ConstructionMethod &constructionMethod, const ConstructionMethod &diverseConstructionMethod, size_t sketchSize, unsigned numberOfInitializationThreads) {
 
 	size_t	referencePopulationSize = elitePopulationSize+diversePopulationSize,
 			totalPopulationSize = referencePopulationSize + referencePopulationSize/2;
 
 	Population<Individual> totalPopulation(totalPopulationSize);
+	DistanceCache distanceCache(totalPopulationSize);
+	DistanceSketch distanceSketch(graph, sketchSize);
+	SolutionHasher solutionHasher;
+	// the reference set and every candidate of an iteration
+	SolutionHashSet populationHashes(totalPopulationSize);
 
 	ScatterSearchPopulation<Individual> population = ScatterSearchPopulation<Individual>(totalPopulation, elitePopulationSize, diversePopulationSize);
 
 	Metrics metrics;
 	random_device seeder;
 	mt19937 randomEngine(seeder());
+	CombinationWorkspace workspace(seeder());
 	StopFunction diverseLocalSearchStopFunction = stop_function_factory::numberOfIterations(localSearchIterations);
 	StopFunction eliteLocalSearchStopFunction = stop_function_factory::numberOfIterations(localSearchIterations*10);
 
@@ -93,37 +160,54 @@ Solution heuristic::scatterSearch (const Graph &graph, size_t elitePopulationSiz
 
 	metrics.executionBegin = chrono::high_resolution_clock::now();
 
-	for (auto i = population.elite.begin(); i < population.elite.end(); i++) {
-		Solution constructedSolution = localSearchHeuristic(graph, constructHeuristicSolution(graph), eliteLocalSearchStopFunction);
-		*i = {constructedSolution, graph.totalPenalty(constructedSolution), 0};
+	for (size_t i = 0; i < totalPopulationSize; i++) {
+		totalPopulation[i].id = i;
 	}
 
-	for (auto i = population.diverse.begin(); i < population.diverse.end(); i++) {
-		Solution constructedSolution = localSearchHeuristic(graph, constructHeuristicSolution(graph), diverseLocalSearchStopFunction);
-		*i = {constructedSolution, graph.totalPenalty(constructedSolution), 0};
+	parallel::initializePopulation(graph, {
+		{population.elite, eliteLocalSearchStopFunction, constructionMethod},
+		{population.diverse, diverseLocalSearchStopFunction, diverseConstructionMethod}
+	}, numberOfInitializationThreads, improvementMethod);
+	for (auto& individual : population.reference) {
+		distanceSketch.update(individual);
+		individual.hash = solutionHasher.hash(individual.solution);
 	}
 
+	// initialization is the longest stretch without a check, so a search stopped at the first one still reports, and returns, its best elite
+	sort(population.elite.begin(), population.elite.end(), [](const auto& a, const auto& b) { return a.penalty < b.penalty; });
 	metrics.numberOfIterations = 0;
 	metrics.numberOfIterationsWithoutImprovement = 0;
-	metrics.penalty = numeric_limits<TimeUnit>::max();
+	metrics.penalty = population.elite[0].penalty;
+	metrics.solution = &population.elite[0].solution;
 	while (stopFunction(metrics)) {
 
 		shuffle(population.reference.begin(), population.reference.end(), randomEngine);
+		populationHashes.clear();
+		for (auto& individual : population.reference) {
+			populationHashes.insert(individual.hash);
+		}
 		for (size_t i = 0; i < population.candidate.size(); i++) {
 
 			auto& individual1 = population.reference[i*2];
 			auto& individual2 = population.reference[i*2+1];
 
-			population.candidate[i].solution = combinationMethod(graph, individual1.solution, individual2.solution);
-			population.candidate[i].solution = localSearchHeuristic(graph, population.candidate[i].solution, diverseLocalSearchStopFunction);
+			distanceCache.invalidate(population.candidate[i].id);
+			// candidates are overwritten in place, so after the first iteration their solutions already have the capacity of a combination
+			combinationMethod(graph, individual1.solution, individual2.solution, population.candidate[i].solution, workspace);
+			// children identical to a member of the population, or to an earlier sibling, are mutated before spending a local search on them
+			populationHashes.insert(solutionHasher.mutateUntilUnique(graph, population.candidate[i].solution, solutionHasher.hash(population.candidate[i].solution), populationHashes, randomEngine));
+			improvementMethod.improve(graph, population.candidate[i].solution, diverseLocalSearchStopFunction);
 			population.candidate[i].penalty = graph.totalPenalty(population.candidate[i].solution);
+			population.candidate[i].hash = solutionHasher.hash(population.candidate[i].solution);
+			distanceSketch.update(population.candidate[i]);
 		}
 
 		sort(population.total.begin(), population.total.end(), [](const auto& a, const auto& b) { return a.penalty < b.penalty; });
 
 		metrics.penalty = population.elite[0].penalty;
+		metrics.solution = &population.elite[0].solution;
 
-		diversify(graph, population);
+		diversify(graph, population, distanceCache, distanceSketch);
 
 		metrics.numberOfIterations++;
 	}
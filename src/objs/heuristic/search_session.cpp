@@ -0,0 +1,96 @@
+#include "search_session.h"
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+SearchSession::SearchSession (const Graph& graph, const Search& search, const StopFunction& stopFunction) :
+	graph(graph),
+	cancelled(false),
+	finished(false)
+{
+	this->worker = thread(&SearchSession::run, this, search, stopFunction);
+}
+
+SearchSession::~SearchSession (void) {
+	this->cancel();
+	this->worker.join();
+}
+
+void SearchSession::publish (const Solution& solution, TimeUnit penalty) {
+	auto current = this->best();
+	if (current && current->penalty <= penalty) {
+		return;
+	}
+	// the copy is made before taking the lock, so readers only ever wait for a pointer swap
+	auto published = make_shared<const BestSolution>(BestSolution{solution, penalty});
+	lock_guard<mutex> guard(this->bestLock);
+	this->bestSolution = published;
+}
+
+void SearchSession::run (const Search& search, const StopFunction& stopFunction) {
+	try {
+		auto solution = search([this, stopFunction](const Metrics& metrics) {
+			if (metrics.solution) {
+				this->publish(*metrics.solution, metrics.penalty);
+			}
+			return !this->cancelled.load() && stopFunction(metrics);
+		}, this->cancelled);
+		this->publish(solution, this->graph.totalPenalty(solution));
+	} catch (...) {
+		this->error = current_exception();
+	}
+
+	lock_guard<mutex> guard(this->finishedLock);
+	this->finished = true;
+	this->finishedNotifier.notify_all();
+}
+
+void SearchSession::cancel (void) {
+	this->cancelled.store(true);
+}
+
+bool SearchSession::isFinished (void) {
+	lock_guard<mutex> guard(this->finishedLock);
+	return this->finished;
+}
+
+shared_ptr<const BestSolution> SearchSession::best (void) const {
+	lock_guard<mutex> guard(this->bestLock);
+	return this->bestSolution;
+}
+
+bool SearchSession::waitFor (chrono::high_resolution_clock::duration timeout) {
+	unique_lock<mutex> lock(this->finishedLock);
+	return this->finishedNotifier.wait_for(lock, timeout, [this]{ return this->finished; });
+}
+
+Solution SearchSession::wait (void) {
+	{
+		unique_lock<mutex> lock(this->finishedLock);
+		this->finishedNotifier.wait(lock, [this]{ return this->finished; });
+	}
+	if (this->error) {
+		rethrow_exception(this->error);
+	}
+	return this->best()->solution;
+}
+
+unique_ptr<SearchSession> heuristic::startScatterSearch (const Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, const ImprovementMethod &improvementMethod, const ConstructionMethod &constructionMethod, const ConstructionMethod &diverseConstructionMethod, size_t sketchSize) {
+	return make_unique<SearchSession>(graph, [=, &graph](const StopFunction& sessionStopFunction, const atomic<bool>& cancelled) {
+		return scatterSearch(graph, elitePopulationSize, diversePopulationSize, localSearchIterations, sessionStopFunction, combinationMethod, improvement_method_factory::cancellable(improvementMethod, cancelled), constructionMethod, diverseConstructionMethod, sketchSize);
+	}, stopFunction);
+}
+
+unique_ptr<SearchSession> heuristic::startGeneticAlgorithm (const Graph& graph, size_t populationSize, const StopFunction &stopFunction, const CombinationMethod &combinationMethod) {
+	// the genetic algorithm runs no local search, so it can only stop between generations
+	return make_unique<SearchSession>(graph, [=, &graph](const StopFunction& sessionStopFunction, const atomic<bool>&) {
+		return geneticAlgorithm(graph, populationSize, sessionStopFunction, combinationMethod);
+	}, stopFunction);
+}
+
+unique_ptr<SearchSession> heuristic::parallel::startScatterSearch (const Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const ImprovementMethod &improvementMethod, const ConstructionMethod &constructionMethod, const ConstructionMethod &diverseConstructionMethod, size_t sketchSize, const MigrationPolicy &migrationPolicy, const NumaPlacement &numaPlacement) {
+	return make_unique<SearchSession>(graph, [=, &graph](const StopFunction& sessionStopFunction, const atomic<bool>& cancelled) {
+		return scatterSearch(graph, elitePopulationSize, diversePopulationSize, localSearchIterations, sessionStopFunction, combinationMethod, numberOfThreads, improvement_method_factory::cancellable(improvementMethod, cancelled), constructionMethod, diverseConstructionMethod, sketchSize, migrationPolicy, numaPlacement);
+	}, stopFunction);
+}
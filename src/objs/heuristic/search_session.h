@@ -0,0 +1,68 @@
+#pragma once
+
+#include "heuristic.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace heuristic {
+
+	struct BestSolution {
+		traffic::Solution solution;
+		traffic::TimeUnit penalty;
+	};
+
+	/*
+	 * A search running on a thread of its own, so a caller with a deadline can start it, read the best solution found so far at any time,
+	 * and cancel it. The search sees a stop function that publishes every improvement reported through Metrics::solution and that stops once
+	 * the session is cancelled. Searches should also hand the cancelled flag to their local searches, as the start functions below do, so that
+	 * cancelling takes effect within milliseconds instead of after the current iteration. The graph must outlive the session
+	 */
+	class SearchSession {
+		public:
+			typedef std::function<traffic::Solution(const StopFunction& stopFunction, const std::atomic<bool>& cancelled)> Search;
+		private:
+			const traffic::Graph& graph;
+			std::atomic<bool> cancelled;
+			mutable std::mutex bestLock;
+			std::shared_ptr<const BestSolution> bestSolution;
+			std::mutex finishedLock;
+			std::condition_variable finishedNotifier;
+			bool finished;
+			std::exception_ptr error;
+			std::thread worker;
+
+			void publish (const traffic::Solution& solution, traffic::TimeUnit penalty);
+			void run (const Search& search, const StopFunction& stopFunction);
+		public:
+			SearchSession (const traffic::Graph& graph, const Search& search, const StopFunction& stopFunction);
+			// cancels the search and waits for it to return
+			~SearchSession (void);
+
+			SearchSession (const SearchSession&) = delete;
+			SearchSession& operator= (const SearchSession&) = delete;
+
+			void cancel (void);
+			bool isFinished (void);
+			// best solution published so far, empty until the search reports one. Never waits for the search
+			std::shared_ptr<const BestSolution> best (void) const;
+			// waits until the search returns or timeout elapses, returning whether it returned
+			bool waitFor (std::chrono::high_resolution_clock::duration timeout);
+			// waits until the search returns and gives its best solution, rethrowing whatever the search threw
+			traffic::Solution wait (void);
+	};
+
+	std::unique_ptr<SearchSession> startScatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, const ImprovementMethod &improvementMethod=improvement_method_factory::localSearch(), const ConstructionMethod &constructionMethod=construction_method_factory::heuristicSolution(), const ConstructionMethod &diverseConstructionMethod=construction_method_factory::heuristicSolution(), size_t sketchSize=0);
+
+	std::unique_ptr<SearchSession> startGeneticAlgorithm (const traffic::Graph& graph, size_t populationSize, const StopFunction &stopFunction, const CombinationMethod &combinationMethod);
+
+	namespace parallel {
+		std::unique_ptr<SearchSession> startScatterSearch (const traffic::Graph& graph, size_t elitePopulationSize, size_t diversePopulationSize, size_t localSearchIterations, const StopFunction &stopFunction, const CombinationMethod &combinationMethod, unsigned numberOfThreads, const ImprovementMethod &improvementMethod=improvement_method_factory::localSearch(), const ConstructionMethod &constructionMethod=construction_method_factory::heuristicSolution(), const ConstructionMethod &diverseConstructionMethod=construction_method_factory::heuristicSolution(), size_t sketchSize=0, const MigrationPolicy &migrationPolicy=MigrationPolicy(), const NumaPlacement &numaPlacement=NumaPlacement());
+	}
+
+}
@@ -0,0 +1,115 @@
+#include "solution_hash.h"
+
+#define MAXIMUM_NUMBER_OF_MUTATIONS 64
+
+#include <algorithm>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+SolutionHasher::SolutionHasher (void) :
+	SolutionHasher(((uint64_t) random_device()() << 32) | random_device()())
+{}
+
+SolutionHasher::SolutionHasher (uint64_t seed) :
+	seed(seed)
+{}
+
+uint64_t SolutionHasher::hash (const Solution& solution) const {
+	uint64_t solutionHash = 0;
+	for (Vertex v = 0; v < solution.size(); v++) {
+		solutionHash ^= this->key(v, solution[v]);
+	}
+	return solutionHash;
+}
+
+uint64_t SolutionHasher::mutateUntilUnique (const Graph& graph, Solution& solution, uint64_t hash, const SolutionHashSet& hashes, mt19937& randomEngine) const {
+	uniform_int_distribution<Vertex> vertexPicker(0, graph.getNumberOfVertices()-1);
+	uniform_int_distribution<TimeUnit> timingPicker(0, graph.getCycle()-1);
+
+	for (unsigned mutation = 0; mutation < MAXIMUM_NUMBER_OF_MUTATIONS && hashes.contains(hash); mutation++) {
+		auto vertex = vertexPicker(randomEngine);
+		auto timing = timingPicker(randomEngine);
+		hash = this->rehash(hash, vertex, solution[vertex], timing);
+		solution[vertex] = timing;
+	}
+	return hash;
+}
+
+SolutionHashSet::SolutionHashSet (size_t expectedNumberOfHashes) :
+	numberOfHashes(0),
+	hasZero(false)
+{
+	this->reserve(expectedNumberOfHashes);
+}
+
+void SolutionHashSet::reserve (size_t expectedNumberOfHashes) {
+	size_t capacity = 2;
+	while (capacity < 2*expectedNumberOfHashes) {
+		capacity *= 2;
+	}
+	if (capacity <= this->slots.size()) {
+		return;
+	}
+
+	vector<uint64_t> previousSlots(capacity, 0);
+	swap(this->slots, previousSlots);
+	size_t mask = capacity-1;
+	for (auto hash : previousSlots) {
+		if (hash != 0) {
+			auto slot = hash & mask;
+			while (this->slots[slot] != 0) {
+				slot = (slot+1) & mask;
+			}
+			this->slots[slot] = hash;
+		}
+	}
+}
+
+void SolutionHashSet::grow (void) {
+	this->reserve(this->slots.size());
+}
+
+void SolutionHashSet::clear (void) {
+	fill(this->slots.begin(), this->slots.end(), 0);
+	this->numberOfHashes = 0;
+	this->hasZero = false;
+}
+
+void SolutionHashSet::insert (uint64_t hash) {
+	if (hash == 0) {
+		this->numberOfHashes += !this->hasZero;
+		this->hasZero = true;
+		return;
+	}
+	if (2*(this->numberOfHashes+1) > this->slots.size()) {
+		this->grow();
+	}
+
+	size_t mask = this->slots.size()-1;
+	for (auto slot = hash & mask; ; slot = (slot+1) & mask) {
+		if (this->slots[slot] == hash) {
+			return;
+		}
+		if (this->slots[slot] == 0) {
+			this->slots[slot] = hash;
+			this->numberOfHashes++;
+			return;
+		}
+	}
+}
+
+bool SolutionHashSet::contains (uint64_t hash) const {
+	if (hash == 0) {
+		return this->hasZero;
+	}
+
+	size_t mask = this->slots.size()-1;
+	for (auto slot = hash & mask; this->slots[slot] != 0; slot = (slot+1) & mask) {
+		if (this->slots[slot] == hash) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace heuristic {
+
+	/*
+	 * Set of solution hashes in a flat open-addressing table with linear probing, sized up front for the population it deduplicates.
+	 * Hashes are already uniformly distributed, so they index the table directly. Inserting and clearing allocate nothing while
+	 * the set stays within the size it was built or reserved for, past which the table doubles
+	 */
+	class SolutionHashSet {
+		private:
+			// 0 marks an empty slot, so a hash of 0 is tracked apart
+			std::vector<uint64_t> slots;
+			size_t numberOfHashes;
+			bool hasZero;
+
+			void grow (void);
+		public:
+			explicit SolutionHashSet (size_t expectedNumberOfHashes=0);
+
+			// keeps the table at most half full for the given number of hashes
+			void reserve (size_t expectedNumberOfHashes);
+			void clear (void);
+			void insert (uint64_t hash);
+			bool contains (uint64_t hash) const;
+
+			inline size_t size (void) const {
+				return this->numberOfHashes;
+			}
+	};
+
+	/*
+	 * Zobrist-style hashing: a solution hashes to the XOR of one pseudo-random key per (vertex, timing) pair, so moving a single vertex
+	 * updates the hash in O(1). Keys are derived from the pair with splitmix64 instead of being stored, which keeps memory independent of V*cycle
+	 */
+	class SolutionHasher {
+		private:
+			uint64_t seed;
+
+			static inline uint64_t splitmix64 (uint64_t x) {
+				x += 0x9e3779b97f4a7c15;
+				x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+				x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+				return x ^ (x >> 31);
+			}
+		public:
+			SolutionHasher (void);
+			SolutionHasher (uint64_t seed);
+
+			inline uint64_t key (traffic::Vertex vertex, traffic::TimeUnit timing) const {
+				return splitmix64(splitmix64(this->seed ^ vertex) ^ (uint64_t) timing);
+			}
+
+			uint64_t hash (const traffic::Solution& solution) const;
+
+			// hash of the solution after vertex moves from oldTiming to newTiming
+			inline uint64_t rehash (uint64_t hash, traffic::Vertex vertex, traffic::TimeUnit oldTiming, traffic::TimeUnit newTiming) const {
+				return hash ^ this->key(vertex, oldTiming) ^ this->key(vertex, newTiming);
+			}
+
+			// gives random vertices random timings until the hash of the solution is not among the given hashes, or 64 vertices were changed, and returns the final hash
+			uint64_t mutateUntilUnique (const traffic::Graph& graph, traffic::Solution& solution, uint64_t hash, const SolutionHashSet& hashes, std::mt19937& randomEngine) const;
+	};
+
+}
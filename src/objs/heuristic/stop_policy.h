@@ -0,0 +1,120 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include <functional>
+#include <chrono>
+#include <atomic>
+
+namespace heuristic {
+
+	struct Metrics {
+		traffic::TimeUnit penalty;
+		unsigned numberOfIterations;
+		unsigned numberOfIterationsWithoutImprovement;
+		std::chrono::high_resolution_clock::time_point executionBegin;
+		// best solution found so far, whose penalty is penalty, for searches that expose it. Only valid during the call to the stop function
+		const traffic::Solution* solution = nullptr;
+	};
+
+	typedef std::function<bool(const Metrics&)> StopFunction;
+
+	/*
+	 * Stop policies are plain function objects: searches templated on them inline the check,
+	 * and the stop_function_factory wraps them in a StopFunction so callers holding a StopFunction
+	 * can recover the concrete policy through StopFunction::target
+	 */
+	namespace stop_policy {
+
+		struct NumberOfIterations {
+			unsigned numberOfIterationsToStop;
+
+			inline bool operator()(const Metrics& metrics) const {
+				return metrics.numberOfIterations < this->numberOfIterationsToStop;
+			}
+		};
+
+		struct NumberOfIterationsWithoutImprovement {
+			unsigned numberOfIterationsToStop;
+
+			inline bool operator()(const Metrics& metrics) const {
+				return metrics.numberOfIterationsWithoutImprovement < this->numberOfIterationsToStop;
+			}
+		};
+
+		struct Penalty {
+			traffic::TimeUnit penalty;
+
+			inline bool operator()(const Metrics& metrics) const {
+				return metrics.penalty > this->penalty;
+			}
+		};
+
+		struct ExecutionTime {
+			std::chrono::high_resolution_clock::duration executionTime;
+
+			inline bool operator()(const Metrics& metrics) const {
+				return std::chrono::high_resolution_clock::now() - metrics.executionBegin < this->executionTime;
+			}
+		};
+
+		/*
+		 * Stops as soon as cancelled is set, from any thread, and otherwise defers to the wrapped policy.
+		 * The flag is read with a relaxed load, so checking it on every iteration of a local search costs next to nothing
+		 */
+		template<typename Policy>
+		struct Cancellable {
+			Policy policy;
+			const std::atomic<bool>* cancelled;
+
+			inline bool operator()(const Metrics& metrics) {
+				return !this->cancelled->load(std::memory_order_relaxed) && this->policy(metrics);
+			}
+		};
+
+		/*
+		 * Only evaluates the wrapped policy every K calls.
+		 * K doubles while checks happen more often than checkInterval/2 and halves while they happen less often than 2*checkInterval,
+		 * so the clock is read at a roughly constant rate regardless of how expensive an iteration is
+		 */
+		template<typename Policy>
+		class Amortized {
+			private:
+				static constexpr unsigned maximumCallsBetweenChecks = 1u << 16;
+
+				Policy policy;
+				std::chrono::high_resolution_clock::duration checkInterval;
+				std::chrono::high_resolution_clock::time_point lastCheck;
+				unsigned callsBetweenChecks;
+				unsigned callsUntilCheck;
+			public:
+				Amortized (const Policy& policy, std::chrono::high_resolution_clock::duration checkInterval=std::chrono::microseconds(100)) :
+					policy(policy),
+					checkInterval(checkInterval),
+					lastCheck(std::chrono::high_resolution_clock::now()),
+					callsBetweenChecks(1),
+					callsUntilCheck(1)
+				{}
+
+				inline bool operator()(const Metrics& metrics) {
+					if (--this->callsUntilCheck > 0) {
+						return true;
+					}
+
+					auto now = std::chrono::high_resolution_clock::now();
+					auto timeSinceLastCheck = now - this->lastCheck;
+					this->lastCheck = now;
+
+					if (timeSinceLastCheck < this->checkInterval/2 && this->callsBetweenChecks < maximumCallsBetweenChecks) {
+						this->callsBetweenChecks *= 2;
+					} else if (timeSinceLastCheck > this->checkInterval*2 && this->callsBetweenChecks > 1) {
+						this->callsBetweenChecks /= 2;
+					}
+					this->callsUntilCheck = this->callsBetweenChecks;
+
+					return this->policy(metrics);
+				}
+		};
+
+	}
+
+}
@@ -0,0 +1,156 @@
+#include "heuristic.h"
+#include "../rng/random_stream.h"
+
+#include <vector>
+#include <cstdint>
+
+using namespace traffic;
+using namespace heuristic;
+using namespace std;
+
+struct TabuMove {
+	Vertex vertex;
+	TimeUnit previousTiming;
+};
+
+/*
+ * Tables of the tabu search, kept per thread so that local searches called once per individual do not allocate V*cycle entries each time.
+ * Expirations are stamped with iterations offset by epoch, which every search advances past all the stamps it wrote,
+ * so the table never needs to be cleared
+ */
+struct TabuWorkspace {
+	// tabuExpiration[v*cycle + t] holds the iteration, offset by epoch, up to which moving v back into timing t is forbidden
+	vector<uint64_t> tabuExpiration;
+	uint64_t epoch = 0;
+	// moves applied after the best known solution was found, undone before returning
+	vector<TabuMove> movesSinceBest;
+	vector<TimeUnit> timingPenalties;
+	vector<TimeUnit> circularDistance;
+};
+
+/*
+ * Fills timingPenalties[t] with the penalty vertex would have if its timing were t, for every t in [0, cycle).
+ * Each neighbor u with edge weight w contributes the circular distances from t to (t_u - w) and to (t_u + w),
+ * so the whole profile costs O(degree*cycle) contiguous additions instead of cycle calls to vertexPenalty
+ */
+void calculateTimingPenalties(const Graph& graph, Vertex vertex, const Solution& solution, const vector<TimeUnit>& circularDistance, TimeUnit* timingPenalties) {
+	TimeUnit cycle = graph.getCycle();
+	const TimeUnit *distanceFromAnchor;
+
+	for (TimeUnit t = 0; t < cycle; t++) {
+		timingPenalties[t] = 0;
+	}
+
+	for (auto& neighbor : graph.neighborsOf(vertex)) {
+		TimeUnit weight = neighbor.second%cycle;
+		TimeUnit anchors[2] = {
+			(solution[neighbor.first] - weight + cycle)%cycle,
+			(solution[neighbor.first] + weight)%cycle
+		};
+		for (auto anchor : anchors) {
+			// circularDistance[j] is the circular distance of j-cycle, so this slice starts at the distance of -anchor
+			distanceFromAnchor = circularDistance.data() + cycle - anchor;
+			for (TimeUnit t = 0; t < cycle; t++) {
+				timingPenalties[t] += distanceFromAnchor[t];
+			}
+		}
+	}
+}
+
+void heuristic::tabuSearchInPlace(const Graph& graph, Solution& solution, const StopFunction &stopCriteriaNotMet, unsigned tabuTenure, unsigned numberOfCandidateVertices) {
+	Vertex nVertices = graph.getNumberOfVertices();
+	TimeUnit cycle = graph.getCycle();
+	TimeUnit infinite = numeric_limits<TimeUnit>::max();
+	TimeUnit currentPenalty, bestPenalty;
+	TimeUnit delta, bestDelta;
+	TimeUnit previousTiming, chosenTiming = 0;
+	Vertex vertex, chosenVertex = 0;
+	uint64_t iteration;
+	const uint64_t *vertexTabuExpiration;
+	Metrics metrics;
+
+	thread_local TabuWorkspace workspace;
+	auto& tabuExpiration = workspace.tabuExpiration;
+	auto& movesSinceBest = workspace.movesSinceBest;
+	auto& timingPenalties = workspace.timingPenalties;
+	auto& circularDistance = workspace.circularDistance;
+	if (tabuExpiration.size() < (size_t) nVertices*cycle) {
+		// new entries hold 0, which is never at or after the first iteration of a search
+		tabuExpiration.resize((size_t) nVertices*cycle, 0);
+	}
+	movesSinceBest.clear();
+	timingPenalties.resize(cycle);
+	circularDistance.resize(2*cycle);
+
+	rng::bounded_stream vertexPicker(nVertices);
+
+	for (TimeUnit j = 0; j < 2*cycle; j++) {
+		circularDistance[j] = min(j%cycle, cycle - j%cycle);
+	}
+
+	currentPenalty = graph.totalPenalty(solution);
+	bestPenalty = currentPenalty;
+
+	metrics.penalty = bestPenalty;
+	metrics.numberOfIterations = 0;
+	metrics.numberOfIterationsWithoutImprovement = 0;
+	metrics.executionBegin = chrono::high_resolution_clock::now();
+	while (stopCriteriaNotMet(metrics)) {
+		iteration = workspace.epoch + metrics.numberOfIterations+1;
+
+		bestDelta = infinite;
+		for (unsigned i = 0; i < numberOfCandidateVertices; i++) {
+			vertex = vertexPicker();
+			previousTiming = solution[vertex];
+			vertexTabuExpiration = tabuExpiration.data() + (size_t) vertex*cycle;
+
+			calculateTimingPenalties(graph, vertex, solution, circularDistance, timingPenalties.data());
+
+			for (TimeUnit t = 0; t < cycle; t++) {
+				if (t == previousTiming) {
+					continue;
+				}
+				delta = timingPenalties[t] - timingPenalties[previousTiming];
+				// aspiration: a tabu move is still allowed if it leads to a new best solution
+				if (vertexTabuExpiration[t] >= iteration && currentPenalty + delta >= bestPenalty) {
+					continue;
+				}
+				if (delta < bestDelta) {
+					bestDelta = delta;
+					chosenVertex = vertex;
+					chosenTiming = t;
+				}
+			}
+		}
+
+		if (bestDelta != infinite) {
+			previousTiming = solution[chosenVertex];
+			tabuExpiration[(size_t) chosenVertex*cycle + previousTiming] = iteration + tabuTenure;
+			solution[chosenVertex] = chosenTiming;
+			currentPenalty += bestDelta;
+			movesSinceBest.push_back({chosenVertex, previousTiming});
+		}
+
+		metrics.numberOfIterations++;
+		if (currentPenalty < bestPenalty) {
+			bestPenalty = currentPenalty;
+			movesSinceBest.clear();
+			metrics.numberOfIterationsWithoutImprovement = 0;
+		} else {
+			metrics.numberOfIterationsWithoutImprovement++;
+		}
+		metrics.penalty = bestPenalty;
+	}
+
+	for (auto move = movesSinceBest.rbegin(); move != movesSinceBest.rend(); move++) {
+		solution[move->vertex] = move->previousTiming;
+	}
+	// every stamp written by this search expires before the first iteration of the next one
+	workspace.epoch += metrics.numberOfIterations + tabuTenure + 1;
+}
+
+Solution heuristic::tabuSearchHeuristic(const Graph& graph, const Solution& initialSolution, const StopFunction &stopCriteriaNotMet, unsigned tabuTenure, unsigned numberOfCandidateVertices) {
+	Solution solution(initialSolution);
+	tabuSearchInPlace(graph, solution, stopCriteriaNotMet, tabuTenure, numberOfCandidateVertices);
+	return solution;
+}
@@ -4,10 +4,11 @@
 #include <list>
 #include <thread>
 #include <vector>
+#include <atomic>
 #include "reusable_thread.h"
 
 namespace parallel {
-	unsigned usable_threads (unsigned number_of_items, unsigned number_of_threads) {
+	inline unsigned usable_threads (unsigned number_of_items, unsigned number_of_threads) {
 		if (number_of_items < number_of_threads) {
 			return 1;
 		} else {
@@ -22,7 +23,7 @@ namespace parallel {
 #define parallel_for(begin, end) {\
 \
 	auto parallel_number_of_threads = parallel_threads_end - parallel_threads_begin; \
-	::std::vector<::std::future<void>> parallel_for_futures(parallel_number_of_threads); \
+	::std::vector<::parallel::completion_token> parallel_for_tokens(parallel_number_of_threads); \
 \
 	decltype(parallel_number_of_threads) parallel_for_items_per_thread = (end-begin)/parallel_number_of_threads; \
 \
@@ -37,7 +38,7 @@ namespace parallel {
 			thread_end = thread_begin + parallel_for_items_per_thread; \
 		} \
 \
-		parallel_for_futures[thread_i] = thread->exec([&, thread_begin, thread_end, thread_i_capture = thread_i](void) { \
+		parallel_for_tokens[thread_i] = thread->exec([&, thread_begin, thread_end, thread_i_capture = thread_i](void) { \
 			[[maybe_unused]] auto thread_i = thread_i_capture; \
 			for (auto i = thread_begin; i < thread_end; i++) \
 
@@ -45,26 +46,52 @@ namespace parallel {
 		}); \
 	} \
 \
-	for (auto &future : parallel_for_futures) { \
-		future.wait(); \
+	::parallel::wait_all(parallel_for_tokens); \
+}
+
+/*
+ * Same as parallel_for, but items are handed out one at a time from a shared counter instead of in equal blocks,
+ * so threads that finish early keep taking items. Meant for loops whose items take very different times
+ */
+#define dynamic_parallel_for(begin, end) {\
+\
+	auto parallel_number_of_threads = parallel_threads_end - parallel_threads_begin; \
+	::std::vector<::parallel::completion_token> parallel_for_tokens(parallel_number_of_threads); \
+\
+	auto parallel_for_begin = begin; \
+	auto parallel_for_number_of_items = end - parallel_for_begin; \
+	::std::atomic<decltype(parallel_for_number_of_items)> parallel_for_next_item(0); \
+\
+	for (auto [thread, thread_i_name] = ::std::make_tuple(parallel_threads_begin, 0u); thread < parallel_threads_end; thread++, thread_i_name++) { \
+\
+		auto thread_i = thread_i_name; \
+\
+		parallel_for_tokens[thread_i] = thread->exec([&, thread_i_capture = thread_i](void) { \
+			[[maybe_unused]] auto thread_i = thread_i_capture; \
+			for (auto parallel_for_item = parallel_for_next_item++; parallel_for_item < parallel_for_number_of_items; parallel_for_item = parallel_for_next_item++) { \
+				auto i = parallel_for_begin + parallel_for_item; \
+
+#define end_dynamic_parallel_for \
+			} \
+		}); \
 	} \
+\
+	::parallel::wait_all(parallel_for_tokens); \
 }
 
 #define for_each_thread {\
 \
 	auto parallel_number_of_threads = parallel_threads_end - parallel_threads_begin; \
-	::std::vector<::std::future<void>> parallel_for_futures(parallel_number_of_threads); \
+	::std::vector<::parallel::completion_token> parallel_for_tokens(parallel_number_of_threads); \
 \
 	for (auto [thread, thread_i_name] = ::std::make_tuple(parallel_threads_begin, 0u); thread < parallel_threads_end; thread++, thread_i_name++) { \
 		unsigned thread_i = thread_i_name; \
-		parallel_for_futures[thread_i] = thread->exec([&, thread_i](void) \
+		parallel_for_tokens[thread_i] = thread->exec([&, thread_i](void) \
 
 #define end_for_each_thread \
 	);} \
 \
-	for (auto &future : parallel_for_futures) { \
-		future.wait(); \
-	} \
+	::parallel::wait_all(parallel_for_tokens); \
 \
 }
 
@@ -0,0 +1,100 @@
+#include "numa.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <dirent.h>
+#include <sched.h>
+
+#define NODE_DIRECTORY "/sys/devices/system/node"
+
+using namespace std;
+using namespace parallel;
+
+vector<unsigned> parallel::parse_cpu_list(const string &cpu_list) {
+	vector<unsigned> cpus;
+	stringstream ranges(cpu_list);
+	string range;
+	while (getline(ranges, range, ',')) {
+		if (range.find_first_not_of(" \t\n") == string::npos) {
+			continue;
+		}
+		auto dash = range.find('-');
+		unsigned first = stoul(range.substr(0, dash));
+		unsigned last = dash == string::npos ? first : stoul(range.substr(dash+1));
+		for (auto cpu = first; cpu <= last; cpu++) {
+			cpus.push_back(cpu);
+		}
+	}
+	return cpus;
+}
+
+numa_topology::numa_topology() {
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	bool knows_allowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+	auto is_allowed = [&](unsigned cpu) {
+		return !knows_allowed || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+	};
+
+	vector<unsigned> nodes;
+	if (auto directory = opendir(NODE_DIRECTORY)) {
+		while (auto entry = readdir(directory)) {
+			string name = entry->d_name;
+			if (name.size() > 4 && name.compare(0, 4, "node") == 0 && name.find_first_not_of("0123456789", 4) == string::npos) {
+				nodes.push_back(stoul(name.substr(4)));
+			}
+		}
+		closedir(directory);
+	}
+
+	for (auto node : nodes) {
+		ifstream cpu_list_file(NODE_DIRECTORY "/node" + to_string(node) + "/cpulist");
+		string cpu_list;
+		getline(cpu_list_file, cpu_list);
+		vector<unsigned> cpus;
+		for (auto cpu : parse_cpu_list(cpu_list)) {
+			if (is_allowed(cpu)) {
+				cpus.push_back(cpu);
+			}
+		}
+		// memory-only nodes and nodes outside the affinity mask have no CPU to pin to
+		if (!cpus.empty()) {
+			this->node_cpus.push_back(cpus);
+		}
+	}
+
+	if (this->node_cpus.empty()) {
+		vector<unsigned> cpus;
+		unsigned number_of_cpus = knows_allowed ? CPU_SETSIZE : max(thread::hardware_concurrency(), 1u);
+		for (unsigned cpu = 0; cpu < number_of_cpus; cpu++) {
+			if (is_allowed(cpu)) {
+				cpus.push_back(cpu);
+			}
+		}
+		this->node_cpus.push_back(cpus);
+	}
+}
+
+numa_topology::numa_topology(const vector<vector<unsigned>> &node_cpus) :
+	node_cpus(node_cpus)
+{
+	if (node_cpus.empty()) {
+		throw invalid_argument("a topology needs at least one node");
+	}
+	for (auto& cpus : node_cpus) {
+		if (cpus.empty()) {
+			throw invalid_argument("every node of a topology needs at least one cpu");
+		}
+	}
+}
+
+unsigned numa_topology::number_of_nodes() const {
+	return this->node_cpus.size();
+}
+
+const vector<unsigned>& numa_topology::cpus_of(unsigned node) const {
+	return this->node_cpus[node];
+}
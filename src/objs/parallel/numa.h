@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace parallel {
+
+	/*
+	 * CPUs of every NUMA node the process may run on, read from /sys/devices/system/node.
+	 * Machines without that directory are seen as a single node holding every allowed CPU
+	 */
+	class numa_topology {
+		private:
+			std::vector<std::vector<unsigned>> node_cpus;
+		public:
+			numa_topology();
+			explicit numa_topology(const std::vector<std::vector<unsigned>> &node_cpus);
+
+			unsigned number_of_nodes() const;
+			const std::vector<unsigned>& cpus_of(unsigned node) const;
+	};
+
+	// parses the kernel's cpu list format, such as "0-3,8-11"
+	std::vector<unsigned> parse_cpu_list(const std::string &cpu_list);
+
+}
@@ -1,59 +1,162 @@
 #include "reusable_thread.h"
 
+#include <pthread.h>
+#include <sched.h>
+
+#define REUSABLE_THREAD_QUEUE_CAPACITY 64
+// yields before a thread with nothing to do sleeps, or a thread waiting for a task blocks, so back to back loops never reach the kernel
+#define REUSABLE_THREAD_SPIN_ITERATIONS 128
+
 using namespace std;
 using namespace parallel;
 
+completion_token::completion_token() :
+	thread(nullptr),
+	ticket(0)
+{}
+
+completion_token::completion_token(reusable_thread *thread, uint64_t ticket) :
+	thread(thread),
+	ticket(ticket)
+{}
+
+bool completion_token::is_complete() const {
+	return this->thread == nullptr || this->thread->completed_tasks.load(memory_order_acquire) >= this->ticket;
+}
+
+void completion_token::wait() const {
+	if (this->thread != nullptr) {
+		this->thread->wait_for(this->ticket);
+	}
+}
+
+void completion_token::get() const {
+	this->wait();
+	if (this->thread != nullptr) {
+		this->thread->rethrow_error(this->ticket);
+	}
+}
+
+void parallel::wait_all(const vector<completion_token> &tokens) {
+	for (auto &token : tokens) {
+		token.wait();
+	}
+	for (auto &token : tokens) {
+		token.get();
+	}
+}
+
 reusable_thread::reusable_thread() :
 	running(true),
-	tasks_count(0),
-	mutex(),
-#ifndef REUSABLE_THREAD_SPINLOCK
-	notifier(),
-#endif
-	thread([this]() {
-		packaged_task<void()> current_task;
-		while(this->running || this->tasks_count > 0) {
+	tasks(REUSABLE_THREAD_QUEUE_CAPACITY),
+	completed_tasks(0),
+	sleeping(false),
+	waiters(0),
+	has_errors(false),
+	thread(&reusable_thread::work, this)
+{}
+
+reusable_thread::~reusable_thread() {
+	if (this->joinable()) {
+		this->join();
+	}
+}
+
+void reusable_thread::work() {
+	for (;;) {
+		for (unsigned spin = 0; spin < REUSABLE_THREAD_SPIN_ITERATIONS && this->tasks.empty() && this->running.load(memory_order_acquire); spin++) {
+			this_thread::yield();
+		}
+
+		if (this->tasks.empty()) {
+			if (!this->running.load(memory_order_acquire)) {
+				return;
+			}
 		#ifdef REUSABLE_THREAD_SPINLOCK
-			while (this->tasks_count == 0) { /* wait for tasks*/ }
-		#endif
+			continue;
+		#else
+			// pairs with the fence in wake: either the producer sees the thread sleeping or the thread sees the task
+			this->sleeping.store(true);
+			atomic_thread_fence(memory_order_seq_cst);
 			{
 				unique_lock<std::mutex> lock(this->mutex);
-			#ifndef REUSABLE_THREAD_SPINLOCK
-				this->notifier.wait(lock, [this]{ return this->tasks_count > 0; });
-			#endif
-				current_task = std::move(this->task_queue.front());
-				this->task_queue.pop_front();
-				this->tasks_count--;
+				this->work_notifier.wait(lock, [this]{ return !this->tasks.empty() || !this->running.load(); });
 			}
-			current_task();
+			this->sleeping.store(false, memory_order_relaxed);
+			continue;
+		#endif
 		}
-	})
-{}
 
-reusable_thread::~reusable_thread() {
-	if (this->joinable()) {
-		this->join();
+		try {
+			this->tasks.run_next();
+		} catch (...) {
+			lock_guard<std::mutex> lock(this->mutex);
+			this->errors.emplace_back(this->completed_tasks.load(memory_order_relaxed)+1, current_exception());
+			this->has_errors.store(true, memory_order_release);
+		}
+
+		this->completed_tasks.fetch_add(1, memory_order_seq_cst);
+		if (this->waiters.load(memory_order_seq_cst) > 0) {
+			lock_guard<std::mutex> lock(this->mutex);
+			this->completion_notifier.notify_all();
+		}
 	}
 }
 
-future<void> reusable_thread::exec(const function<void()> &task) {
-	packaged_task<void()> packaged_task(task);
-	auto future = packaged_task.get_future();
-	{
+void reusable_thread::wake() {
+#ifndef REUSABLE_THREAD_SPINLOCK
+	atomic_thread_fence(memory_order_seq_cst);
+	if (this->sleeping.load(memory_order_relaxed)) {
 		lock_guard<std::mutex> lock(this->mutex);
-		this->task_queue.emplace_back(std::move(packaged_task));
-		this->tasks_count++;
+		this->work_notifier.notify_one();
 	}
-#ifndef REUSABLE_THREAD_SPINLOCK
-	this->notifier.notify_one();
 #endif
+}
+
+void reusable_thread::wait_for(uint64_t ticket) {
+	for (unsigned spin = 0; spin < REUSABLE_THREAD_SPIN_ITERATIONS; spin++) {
+		if (this->completed_tasks.load(memory_order_acquire) >= ticket) {
+			return;
+		}
+		this_thread::yield();
+	}
 
-	return future;
+	this->waiters.fetch_add(1, memory_order_seq_cst);
+	{
+		unique_lock<std::mutex> lock(this->mutex);
+		this->completion_notifier.wait(lock, [this, ticket]{ return this->completed_tasks.load(memory_order_seq_cst) >= ticket; });
+	}
+	this->waiters.fetch_sub(1, memory_order_relaxed);
+}
+
+void reusable_thread::rethrow_error(uint64_t ticket) {
+	if (!this->has_errors.load(memory_order_acquire)) {
+		return;
+	}
+
+	exception_ptr error;
+	{
+		lock_guard<std::mutex> lock(this->mutex);
+		for (auto it = this->errors.begin(); it != this->errors.end(); it++) {
+			if (it->first == ticket) {
+				error = it->second;
+				this->errors.erase(it);
+				break;
+			}
+		}
+		this->has_errors.store(!this->errors.empty(), memory_order_release);
+	}
+	if (error) {
+		rethrow_exception(error);
+	}
 }
 
 void reusable_thread::join() {
-	this->running = false;
-	this->exec([]{ /* empty task */ });
+	this->running.store(false, memory_order_release);
+	{
+		lock_guard<std::mutex> lock(this->mutex);
+		this->work_notifier.notify_one();
+	}
 	this->thread.join();
 }
 
@@ -61,6 +164,17 @@ bool reusable_thread::joinable() const {
 	return this->thread.joinable();
 }
 
+bool reusable_thread::pin(const vector<unsigned> &cpus) {
+	cpu_set_t cpu_set;
+	CPU_ZERO(&cpu_set);
+	for (auto cpu : cpus) {
+		if (cpu < CPU_SETSIZE) {
+			CPU_SET(cpu, &cpu_set);
+		}
+	}
+	return pthread_setaffinity_np(this->thread.native_handle(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
 thread_pile::slice_t::slice_t(iterator begin, iterator end) :
 	begin(begin),
 	end(end)
@@ -86,6 +200,28 @@ reusable_thread& thread_pile::operator[](unsigned thread_index) {
 	return this->threads[thread_index];
 }
 
+void thread_pile::pin(const numa_topology &topology) {
+	auto number_of_nodes = topology.number_of_nodes();
+	auto call_depth = this->threads.size()/this->number_of_threads;
+	this->thread_nodes.resize(this->number_of_threads);
+
+	for (unsigned thread_index = 0; thread_index < this->number_of_threads; thread_index++) {
+		unsigned node = (unsigned long long) thread_index*number_of_nodes/this->number_of_threads;
+		unsigned node_begin = (node*this->number_of_threads + number_of_nodes-1)/number_of_nodes;
+		auto& cpus = topology.cpus_of(node);
+		this->thread_nodes[thread_index] = node;
+
+		this->threads[thread_index].pin({cpus[(thread_index-node_begin)%cpus.size()]});
+		for (unsigned depth = 1; depth < call_depth; depth++) {
+			this->threads[depth*this->number_of_threads+thread_index].pin(cpus);
+		}
+	}
+}
+
+unsigned thread_pile::node_of(unsigned thread_index) const {
+	return thread_index < this->thread_nodes.size() ? this->thread_nodes[thread_index] : 0;
+}
+
 thread_pile::slice_t thread_pile::depth(unsigned depth) {
 	auto depth_begin = this->threads.begin()+depth*this->number_of_threads;
 	return slice_t{
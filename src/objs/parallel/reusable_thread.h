@@ -2,38 +2,84 @@
 
 //#define REUSABLE_THREAD_SPINLOCK
 
-#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <mutex>
-#include <future>
-#include <list>
-#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "task_queue.h"
+#include "numa.h"
 
 namespace parallel {
 
+	class reusable_thread;
+
+	/*
+	 * Completion of one task given to a reusable_thread. Tasks run in the order they were given, so a token only holds the position of its task
+	 * and is complete once the thread has run that many tasks. A default constructed token is always complete
+	 */
+	class completion_token {
+		private:
+			reusable_thread *thread;
+			uint64_t ticket;
+		public:
+			completion_token();
+			completion_token(reusable_thread *thread, uint64_t ticket);
+
+			bool is_complete() const;
+			void wait() const;
+			// waits, then rethrows whatever the task threw
+			void get() const;
+	};
+
+	// waits for every token before rethrowing the first error, since the tasks may still be using what a rethrow would unwind
+	void wait_all(const std::vector<completion_token> &tokens);
+
 	class reusable_thread {
 		private:
-			volatile bool running;
-			volatile unsigned tasks_count;
+			friend class completion_token;
+
+			std::atomic<bool> running;
+			task_queue tasks;
+			std::atomic<uint64_t> completed_tasks;
+			std::atomic<bool> sleeping;
+			std::atomic<unsigned> waiters;
 			std::mutex mutex;
-		#ifndef REUSABLE_THREAD_SPINLOCK
-			std::condition_variable notifier;
-		#endif
+			std::condition_variable work_notifier;
+			std::condition_variable completion_notifier;
+			std::atomic<bool> has_errors;
+			std::vector<std::pair<uint64_t, std::exception_ptr>> errors;
 			std::thread thread;
-			std::list<std::packaged_task<void()>> task_queue;
+
+			void work();
+			void wake();
+			void wait_for(uint64_t ticket);
+			void rethrow_error(uint64_t ticket);
 
 		public:
 			reusable_thread();
 			~reusable_thread();
 
-			std::future<void> exec(const std::function<void()> &task);
+			template<typename Task>
+			completion_token exec(Task &&task) {
+				auto ticket = this->tasks.push(std::forward<Task>(task));
+				this->wake();
+				return completion_token(this, ticket);
+			}
 			void join();
 			bool joinable() const;
+			// restricts the thread to the given cpus, false when the system refuses
+			bool pin(const std::vector<unsigned> &cpus);
 	};
 
 	class thread_pile {
 		private:
 			unsigned number_of_threads;
 			std::vector<reusable_thread> threads;
+			std::vector<unsigned> thread_nodes;
 		public:
 			typedef decltype(threads)::iterator iterator;
 			struct slice_t {
@@ -50,6 +96,14 @@ namespace parallel {
 			thread_pile() = default;
 
 			reusable_thread& operator[](unsigned thread_index);
+
+			/*
+			 * Spreads the threads over the nodes in contiguous blocks, so neighboring thread indices share a node.
+			 * Threads at depth 0 are pinned to one cpu each, deeper ones, which help the thread of the same index, to any cpu of its node
+			 */
+			void pin(const numa_topology &topology);
+			// node of the threads with the given index within a depth, 0 for threads that were never pinned
+			unsigned node_of(unsigned thread_index) const;
 			slice_t depth(unsigned depth);
 
 			slice_t slice (unsigned begin, unsigned end);
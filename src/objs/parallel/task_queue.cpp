@@ -0,0 +1,43 @@
+#include "task_queue.h"
+
+using namespace std;
+using namespace parallel;
+
+task_queue::task_queue(size_t capacity) :
+	tail(0),
+	head(0)
+{
+	size_t rounded_capacity = 1;
+	while (rounded_capacity < capacity) {
+		rounded_capacity *= 2;
+	}
+	this->mask = rounded_capacity-1;
+	this->slots.reset(new slot[rounded_capacity]);
+	for (size_t i = 0; i < rounded_capacity; i++) {
+		this->slots[i].sequence.store(i, memory_order_relaxed);
+	}
+}
+
+bool task_queue::empty() const {
+	auto& target = this->slots[this->head & this->mask];
+	return target.sequence.load(memory_order_acquire) != this->head+1;
+}
+
+bool task_queue::run_next() {
+	auto& target = this->slots[this->head & this->mask];
+	if (target.sequence.load(memory_order_acquire) != this->head+1) {
+		return false;
+	}
+
+	struct slot_releaser {
+		slot &target;
+		uint64_t &head;
+		size_t capacity;
+		~slot_releaser() {
+			this->target.sequence.store(this->head+this->capacity, memory_order_release);
+			this->head++;
+		}
+	} release_after_run{target, this->head, this->mask+1};
+	target.task.run();
+	return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace parallel {
+
+	/*
+	 * Type-erased void() task stored inside the object when it fits, which covers the lambdas of the parallel macros,
+	 * and on the heap otherwise. A task runs exactly once and is destroyed by running it
+	 */
+	class inline_task {
+		public:
+			static constexpr size_t storage_size = 104;
+		private:
+			alignas(std::max_align_t) unsigned char storage[storage_size];
+			void (*run_and_destroy)(unsigned char *storage);
+
+			template<typename Task>
+			static void run_inline(unsigned char *storage) {
+				auto task = std::launder(reinterpret_cast<Task*>(storage));
+				struct destroyer {
+					Task *task;
+					~destroyer() { task->~Task(); }
+				} destroy_after_run{task};
+				(*task)();
+			}
+
+			template<typename Task>
+			static void run_on_heap(unsigned char *storage) {
+				std::unique_ptr<Task> task(*std::launder(reinterpret_cast<Task**>(storage)));
+				(*task)();
+			}
+		public:
+			inline_task() = default;
+			inline_task(const inline_task&) = delete;
+			inline_task& operator=(const inline_task&) = delete;
+
+			template<typename Task>
+			void emplace(Task &&task) {
+				typedef std::decay_t<Task> stored_task;
+				if constexpr (sizeof(stored_task) <= storage_size && alignof(stored_task) <= alignof(std::max_align_t)) {
+					new (this->storage) stored_task(std::forward<Task>(task));
+					this->run_and_destroy = &run_inline<stored_task>;
+				} else {
+					new (this->storage) stored_task*(new stored_task(std::forward<Task>(task)));
+					this->run_and_destroy = &run_on_heap<stored_task>;
+				}
+			}
+
+			inline void run() {
+				this->run_and_destroy(this->storage);
+			}
+	};
+
+	/*
+	 * Bounded lock-free queue of tasks with any number of producers and a single consumer, over a ring of pre-allocated slots.
+	 * Every slot carries a sequence number telling whether it is free for the push of a given position or holds the task of that position,
+	 * so producers only contend on the tail counter and the consumer never writes anything a producer reads but the sequence of a slot.
+	 * push returns the 1-based position of the task, which the consumer's count of completed tasks reaches once the task has run
+	 */
+	class task_queue {
+		private:
+			static constexpr size_t cache_line_size = 64;
+
+			struct alignas(cache_line_size) slot {
+				std::atomic<uint64_t> sequence;
+				inline_task task;
+			};
+
+			size_t mask;
+			std::unique_ptr<slot[]> slots;
+			alignas(cache_line_size) std::atomic<uint64_t> tail;
+			alignas(cache_line_size) uint64_t head;
+		public:
+			// capacity is rounded up to a power of 2
+			explicit task_queue(size_t capacity);
+
+			task_queue(const task_queue&) = delete;
+			task_queue& operator=(const task_queue&) = delete;
+
+			// waits for a free slot when the queue is full, so a consumer must never push to its own full queue
+			template<typename Task>
+			uint64_t push(Task &&task) {
+				auto position = this->tail.load(std::memory_order_relaxed);
+				slot *target;
+				for (;;) {
+					target = &this->slots[position & this->mask];
+					auto sequence = target->sequence.load(std::memory_order_acquire);
+					auto difference = (int64_t) (sequence - position);
+					if (difference == 0) {
+						if (this->tail.compare_exchange_weak(position, position+1, std::memory_order_relaxed)) {
+							break;
+						}
+					} else if (difference < 0) {
+						std::this_thread::yield();
+						position = this->tail.load(std::memory_order_relaxed);
+					} else {
+						position = this->tail.load(std::memory_order_relaxed);
+					}
+				}
+
+				target->task.emplace(std::forward<Task>(task));
+				target->sequence.store(position+1, std::memory_order_release);
+				return position+1;
+			}
+
+			// consumer only
+			bool empty() const;
+			// consumer only: runs the task at the head, false when there is none. The slot is freed even if the task throws
+			bool run_next();
+	};
+
+}
@@ -0,0 +1,357 @@
+#include "partition.h"
+
+#include <vector>
+#include <queue>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+#define COARSEST_VERTICES_PER_PART 20
+#define MINIMUM_COARSENING_RATIO 0.95
+#define NUMBER_OF_INITIAL_PARTITIONS 4
+#define NUMBER_OF_REFINEMENT_PASSES 4
+
+using namespace traffic;
+using namespace partition;
+using namespace std;
+
+/*
+ * Graph used while coarsening, in compressed sparse row form.
+ * Vertex weights count the original vertices merged into a vertex and edge weights count the original edges merged into an edge
+ */
+struct WeightedGraph {
+	vector<size_t> offsets;
+	vector<Vertex> neighbors;
+	vector<size_t> edgeWeights;
+	vector<size_t> vertexWeights;
+
+	Vertex size (void) const {
+		return this->vertexWeights.size();
+	}
+};
+
+WeightedGraph weightedGraphOf (const Graph& graph) {
+	WeightedGraph weightedGraph;
+	Vertex nVertices = graph.getNumberOfVertices();
+
+	weightedGraph.vertexWeights.assign(nVertices, 1);
+	weightedGraph.offsets.reserve(nVertices+1);
+	weightedGraph.offsets.push_back(0);
+	for (Vertex v = 0; v < nVertices; v++) {
+		for (auto& neighbor : graph.neighborsOf(v)) {
+			if (neighbor.first != v) {
+				weightedGraph.neighbors.push_back(neighbor.first);
+				weightedGraph.edgeWeights.push_back(1);
+			}
+		}
+		weightedGraph.offsets.push_back(weightedGraph.neighbors.size());
+	}
+
+	return weightedGraph;
+}
+
+// visits vertices in random order and matches each unmatched vertex with the unmatched neighbor sharing the heaviest edge
+vector<Vertex> heavyEdgeMatching (const WeightedGraph& graph, size_t maximumVertexWeight, Vertex& numberOfCoarseVertices, mt19937& randomEngine) {
+	Vertex nVertices = graph.size();
+	Vertex unmatched = nVertices;
+	vector<Vertex> coarseVertexOf(nVertices, unmatched);
+	vector<Vertex> visitOrder(nVertices);
+	Vertex match;
+	size_t heaviestEdge;
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		visitOrder[v] = v;
+	}
+	shuffle(visitOrder.begin(), visitOrder.end(), randomEngine);
+
+	numberOfCoarseVertices = 0;
+	for (auto v : visitOrder) {
+		if (coarseVertexOf[v] != unmatched) {
+			continue;
+		}
+
+		match = unmatched;
+		heaviestEdge = 0;
+		for (size_t e = graph.offsets[v]; e < graph.offsets[v+1]; e++) {
+			auto u = graph.neighbors[e];
+			if (coarseVertexOf[u] == unmatched && graph.edgeWeights[e] > heaviestEdge && graph.vertexWeights[v] + graph.vertexWeights[u] <= maximumVertexWeight) {
+				match = u;
+				heaviestEdge = graph.edgeWeights[e];
+			}
+		}
+
+		coarseVertexOf[v] = numberOfCoarseVertices;
+		if (match != unmatched) {
+			coarseVertexOf[match] = numberOfCoarseVertices;
+		}
+		numberOfCoarseVertices++;
+	}
+
+	return coarseVertexOf;
+}
+
+WeightedGraph contract (const WeightedGraph& graph, const vector<Vertex>& coarseVertexOf, Vertex numberOfCoarseVertices) {
+	WeightedGraph coarseGraph;
+	vector<vector<Vertex>> members(numberOfCoarseVertices);
+	// position of the edge to each coarse neighbor in coarseGraph.neighbors, valid only if it is past the offset of the current coarse vertex
+	vector<long> edgePosition(numberOfCoarseVertices, -1);
+
+	for (Vertex v = 0; v < graph.size(); v++) {
+		members[coarseVertexOf[v]].push_back(v);
+	}
+
+	coarseGraph.vertexWeights.assign(numberOfCoarseVertices, 0);
+	coarseGraph.offsets.reserve(numberOfCoarseVertices+1);
+	coarseGraph.offsets.push_back(0);
+	for (Vertex c = 0; c < numberOfCoarseVertices; c++) {
+		long coarseVertexBegin = coarseGraph.neighbors.size();
+		for (auto v : members[c]) {
+			coarseGraph.vertexWeights[c] += graph.vertexWeights[v];
+			for (size_t e = graph.offsets[v]; e < graph.offsets[v+1]; e++) {
+				auto coarseNeighbor = coarseVertexOf[graph.neighbors[e]];
+				if (coarseNeighbor == c) {
+					continue;
+				}
+				if (edgePosition[coarseNeighbor] < coarseVertexBegin) {
+					edgePosition[coarseNeighbor] = coarseGraph.neighbors.size();
+					coarseGraph.neighbors.push_back(coarseNeighbor);
+					coarseGraph.edgeWeights.push_back(graph.edgeWeights[e]);
+				} else {
+					coarseGraph.edgeWeights[edgePosition[coarseNeighbor]] += graph.edgeWeights[e];
+				}
+			}
+		}
+		coarseGraph.offsets.push_back(coarseGraph.neighbors.size());
+	}
+
+	return coarseGraph;
+}
+
+size_t weightedEdgeCut (const WeightedGraph& graph, const Partition& partition) {
+	size_t cut = 0;
+	for (Vertex v = 0; v < graph.size(); v++) {
+		for (size_t e = graph.offsets[v]; e < graph.offsets[v+1]; e++) {
+			if (partition[v] != partition[graph.neighbors[e]]) {
+				cut += graph.edgeWeights[e];
+			}
+		}
+	}
+	return cut/2;
+}
+
+// each part but the last is grown breadth-first from a random vertex until it holds its share of the total weight
+Partition growPartition (const WeightedGraph& graph, unsigned numberOfParts, mt19937& randomEngine) {
+	Vertex nVertices = graph.size();
+	Partition partition(nVertices, numberOfParts);
+	vector<Vertex> seeds(nVertices);
+	queue<Vertex> growQueue;
+	size_t totalWeight = 0, partWeight, targetWeight;
+	size_t nextSeed = 0;
+	Vertex vertex;
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		seeds[v] = v;
+		totalWeight += graph.vertexWeights[v];
+	}
+	shuffle(seeds.begin(), seeds.end(), randomEngine);
+	targetWeight = totalWeight/numberOfParts;
+
+	for (unsigned part = 0; part+1 < numberOfParts; part++) {
+		partWeight = 0;
+		growQueue = queue<Vertex>();
+		while (partWeight < targetWeight) {
+			if (growQueue.empty()) {
+				// the part ran out of reachable vertices, so it continues from another component
+				while (nextSeed < nVertices && partition[seeds[nextSeed]] != numberOfParts) {
+					nextSeed++;
+				}
+				if (nextSeed == nVertices) {
+					break;
+				}
+				growQueue.push(seeds[nextSeed]);
+			}
+
+			vertex = growQueue.front();
+			growQueue.pop();
+			if (partition[vertex] != numberOfParts) {
+				continue;
+			}
+
+			partition[vertex] = part;
+			partWeight += graph.vertexWeights[vertex];
+			for (size_t e = graph.offsets[vertex]; e < graph.offsets[vertex+1]; e++) {
+				if (partition[graph.neighbors[e]] == numberOfParts) {
+					growQueue.push(graph.neighbors[e]);
+				}
+			}
+		}
+	}
+
+	for (auto& part : partition) {
+		if (part == numberOfParts) {
+			part = numberOfParts-1;
+		}
+	}
+
+	return partition;
+}
+
+/*
+ * Greedy boundary refinement: every vertex is moved to the neighboring part it has the most edge weight to,
+ * if that lowers the cut without overloading the destination, or keeps the cut and evens out the two parts.
+ * Vertices of an overloaded part are moved out even if the cut grows, which restores the balance lost while projecting
+ */
+void refinePartition (const WeightedGraph& graph, Partition& partition, unsigned numberOfParts, size_t maximumPartWeight) {
+	Vertex nVertices = graph.size();
+	vector<size_t> partWeights(numberOfParts, 0);
+	vector<long> connection(numberOfParts, 0);
+	vector<unsigned> connectedParts;
+	bool moved = true;
+
+	for (Vertex v = 0; v < nVertices; v++) {
+		partWeights[partition[v]] += graph.vertexWeights[v];
+	}
+
+	for (unsigned pass = 0; pass < NUMBER_OF_REFINEMENT_PASSES && moved; pass++) {
+		moved = false;
+		for (Vertex v = 0; v < nVertices; v++) {
+			unsigned currentPart = partition[v];
+			size_t vertexWeight = graph.vertexWeights[v];
+
+			connectedParts.clear();
+			for (size_t e = graph.offsets[v]; e < graph.offsets[v+1]; e++) {
+				auto neighborPart = partition[graph.neighbors[e]];
+				if (connection[neighborPart] == 0) {
+					connectedParts.push_back(neighborPart);
+				}
+				connection[neighborPart] += graph.edgeWeights[e];
+			}
+
+			unsigned bestPart = currentPart;
+			long bestGain = numeric_limits<long>::min();
+			for (auto part : connectedParts) {
+				if (part != currentPart && partWeights[part] + vertexWeight <= maximumPartWeight && connection[part] - connection[currentPart] > bestGain) {
+					bestPart = part;
+					bestGain = connection[part] - connection[currentPart];
+				}
+			}
+
+			if (bestPart != currentPart && partWeights[currentPart] > vertexWeight) {
+				bool isOverloaded = partWeights[currentPart] > maximumPartWeight;
+				bool evensOut = bestGain == 0 && partWeights[bestPart] + vertexWeight < partWeights[currentPart];
+				if (bestGain > 0 || evensOut || isOverloaded) {
+					partition[v] = bestPart;
+					partWeights[currentPart] -= vertexWeight;
+					partWeights[bestPart] += vertexWeight;
+					moved = true;
+				}
+			}
+
+			for (auto part : connectedParts) {
+				connection[part] = 0;
+			}
+		}
+	}
+}
+
+Partition partition::multilevelPartition (const Graph& graph, unsigned numberOfParts, double imbalanceTolerance) {
+	Vertex nVertices = graph.getNumberOfVertices();
+
+	if (numberOfParts < 1) {
+		throw invalid_argument("numberOfParts must be greater than 0");
+	}
+	if (numberOfParts > nVertices) {
+		throw invalid_argument("numberOfParts cannot be greater than the number of vertices");
+	}
+	if (imbalanceTolerance < 0) {
+		throw invalid_argument("imbalanceTolerance cannot be negative");
+	}
+	if (numberOfParts == 1) {
+		return Partition(nVertices, 0);
+	}
+
+	random_device seeder;
+	mt19937 randomEngine(seeder());
+	size_t maximumPartWeight = ceil((1.0+imbalanceTolerance)*nVertices/numberOfParts);
+	size_t maximumVertexWeight = max<size_t>(1, 1.5*nVertices/(COARSEST_VERTICES_PER_PART*numberOfParts));
+	vector<WeightedGraph> levels;
+	vector<vector<Vertex>> coarseVertexOf;
+
+	levels.push_back(weightedGraphOf(graph));
+	while (levels.back().size() > COARSEST_VERTICES_PER_PART*numberOfParts) {
+		Vertex numberOfCoarseVertices;
+		auto matching = heavyEdgeMatching(levels.back(), maximumVertexWeight, numberOfCoarseVertices, randomEngine);
+		if (numberOfCoarseVertices > MINIMUM_COARSENING_RATIO*levels.back().size()) {
+			break;
+		}
+		levels.push_back(contract(levels.back(), matching, numberOfCoarseVertices));
+		coarseVertexOf.push_back(move(matching));
+	}
+
+	Partition bestPartition;
+	size_t bestCut = numeric_limits<size_t>::max();
+	for (unsigned attempt = 0; attempt < NUMBER_OF_INITIAL_PARTITIONS; attempt++) {
+		auto partition = growPartition(levels.back(), numberOfParts, randomEngine);
+		refinePartition(levels.back(), partition, numberOfParts, maximumPartWeight);
+		auto cut = weightedEdgeCut(levels.back(), partition);
+		if (cut < bestCut) {
+			bestCut = cut;
+			bestPartition = move(partition);
+		}
+	}
+
+	for (size_t level = levels.size()-1; level > 0; level--) {
+		auto& fineGraph = levels[level-1];
+		auto& projection = coarseVertexOf[level-1];
+		Partition finePartition(fineGraph.size());
+		for (Vertex v = 0; v < fineGraph.size(); v++) {
+			finePartition[v] = bestPartition[projection[v]];
+		}
+		refinePartition(fineGraph, finePartition, numberOfParts, maximumPartWeight);
+		bestPartition = move(finePartition);
+	}
+
+	return bestPartition;
+}
+
+size_t partition::edgeCut (const Graph& graph, const Partition& partition) {
+	size_t cut = 0;
+	for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+		for (auto& neighbor : graph.neighborsOf(v)) {
+			if (v < neighbor.first && partition[v] != partition[neighbor.first]) {
+				cut++;
+			}
+		}
+	}
+	return cut;
+}
+
+vector<vector<Vertex>> partition::partMembers (const Partition& partition, unsigned numberOfParts) {
+	vector<vector<Vertex>> members(numberOfParts);
+	for (Vertex v = 0; v < partition.size(); v++) {
+		members[partition[v]].push_back(v);
+	}
+	return members;
+}
+
+AdjacencyListGraph* partition::buildInducedSubgraph (const Graph& graph, const vector<Vertex>& vertices) {
+	unordered_map<Vertex, Vertex> subgraphVertexOf;
+	auto adjacencyList = new unordered_map<Vertex, Weight>[vertices.size()];
+
+	subgraphVertexOf.reserve(vertices.size());
+	for (Vertex i = 0; i < vertices.size(); i++) {
+		subgraphVertexOf[vertices[i]] = i;
+	}
+
+	for (Vertex i = 0; i < vertices.size(); i++) {
+		for (auto& neighbor : graph.neighborsOf(vertices[i])) {
+			auto subgraphNeighbor = subgraphVertexOf.find(neighbor.first);
+			if (subgraphNeighbor != subgraphVertexOf.end()) {
+				adjacencyList[i][subgraphNeighbor->second] = neighbor.second;
+			}
+		}
+	}
+
+	return new AdjacencyListGraph(adjacencyList, vertices.size(), graph.getCycle());
+}
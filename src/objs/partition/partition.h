@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../traffic_graph/traffic_graph.h"
+#include <vector>
+
+namespace partition {
+
+	// part index of every vertex
+	typedef std::vector<unsigned> Partition;
+
+	/*
+	 * Multilevel k-way partitioning: the graph is coarsened by heavy-edge matching, the coarsest graph is split by greedy graph growing,
+	 * and the split is projected back level by level with boundary refinement. Parts are balanced by number of vertices,
+	 * each holding at most (1+imbalanceTolerance)*numberOfVertices/numberOfParts of them, while the number of cut edges is kept low
+	 */
+	Partition multilevelPartition (const traffic::Graph& graph, unsigned numberOfParts, double imbalanceTolerance=0.03);
+
+	size_t edgeCut (const traffic::Graph& graph, const Partition& partition);
+
+	std::vector<std::vector<traffic::Vertex>> partMembers (const Partition& partition, unsigned numberOfParts);
+
+	// vertex i of the returned graph is vertices[i], and only edges between listed vertices are kept
+	traffic::AdjacencyListGraph* buildInducedSubgraph (const traffic::Graph& graph, const std::vector<traffic::Vertex>& vertices);
+
+}
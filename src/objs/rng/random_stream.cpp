@@ -0,0 +1,144 @@
+#include "random_stream.h"
+
+#include <random>
+#include <stdexcept>
+
+using namespace rng;
+using namespace std;
+
+uint64_t splitmix64(uint64_t &state) {
+	uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+uint64_t random_seed() {
+	random_device seeder;
+	return (static_cast<uint64_t>(seeder()) << 32) ^ seeder();
+}
+
+xoshiro256_lanes::xoshiro256_lanes() :
+	xoshiro256_lanes(random_seed())
+{}
+
+xoshiro256_lanes::xoshiro256_lanes(uint64_t seed) {
+	this->seed(seed);
+}
+
+void xoshiro256_lanes::seed(uint64_t seed) {
+	uint64_t state = seed;
+	for (unsigned lane = 0; lane < lanes; lane++) {
+	#if defined(__GNUC__)
+		this->s0[lane] = splitmix64(state);
+		this->s1[lane] = splitmix64(state);
+		this->s2[lane] = splitmix64(state);
+		this->s3[lane] = splitmix64(state);
+	#else
+		this->s0.lane[lane] = splitmix64(state);
+		this->s1.lane[lane] = splitmix64(state);
+		this->s2.lane[lane] = splitmix64(state);
+		this->s3.lane[lane] = splitmix64(state);
+	#endif
+	}
+}
+
+void xoshiro256_lanes::fill(uint64_t *output, size_t size) {
+#if defined(__GNUC__)
+	state_t result, t;
+	for (size_t i = 0; i < size; i += lanes) {
+		result = this->s0 + this->s3;
+		t = this->s1 << 17;
+
+		this->s2 ^= this->s0;
+		this->s3 ^= this->s1;
+		this->s1 ^= this->s2;
+		this->s0 ^= this->s3;
+		this->s2 ^= t;
+		this->s3 = (this->s3 << 45) | (this->s3 >> 19);
+
+		for (unsigned lane = 0; lane < lanes; lane++) {
+			output[i+lane] = result[lane];
+		}
+	}
+#else
+	uint64_t t;
+	for (size_t i = 0; i < size; i += lanes) {
+		for (unsigned lane = 0; lane < lanes; lane++) {
+			output[i+lane] = this->s0.lane[lane] + this->s3.lane[lane];
+			t = this->s1.lane[lane] << 17;
+
+			this->s2.lane[lane] ^= this->s0.lane[lane];
+			this->s3.lane[lane] ^= this->s1.lane[lane];
+			this->s1.lane[lane] ^= this->s2.lane[lane];
+			this->s0.lane[lane] ^= this->s3.lane[lane];
+			this->s2.lane[lane] ^= t;
+			this->s3.lane[lane] = (this->s3.lane[lane] << 45) | (this->s3.lane[lane] >> 19);
+		}
+	}
+#endif
+}
+
+uint64_t xoshiro256_lanes::next() {
+	uint64_t output[lanes];
+	this->fill(output, lanes);
+	return output[0];
+}
+
+bounded_stream::bounded_stream(size_t bound) :
+	position(block_size)
+{
+	if (bound == 0) {
+		throw invalid_argument("bound must be greater than 0");
+	}
+	if (bound > UINT32_MAX) {
+		throw invalid_argument("bound must fit in 32 bits");
+	}
+	this->bound = static_cast<uint32_t>(bound);
+	// -bound%bound == (2^32 - bound)%bound, the number of low products that would bias the result
+	this->rejection_threshold = static_cast<uint32_t>(-this->bound)%this->bound;
+}
+
+void bounded_stream::refill() {
+	uint64_t raw[block_size];
+	uint64_t product;
+	bool has_rejection = false;
+
+	this->generator.fill(raw, block_size);
+
+	for (size_t i = 0; i < block_size; i++) {
+		product = (raw[i] >> 32) * this->bound;
+		this->block[i] = static_cast<uint32_t>(product >> 32);
+		has_rejection |= static_cast<uint32_t>(product) < this->rejection_threshold;
+	}
+
+	// rejections happen with probability bound/2^32, so the slow path is almost never taken
+	if (has_rejection) {
+		for (size_t i = 0; i < block_size; i++) {
+			product = (raw[i] >> 32) * this->bound;
+			while (static_cast<uint32_t>(product) < this->rejection_threshold) {
+				product = (this->generator.next() >> 32) * this->bound;
+			}
+			this->block[i] = static_cast<uint32_t>(product >> 32);
+		}
+	}
+
+	this->position = 0;
+}
+
+uniform_stream::uniform_stream() :
+	position(block_size)
+{}
+
+void uniform_stream::refill() {
+	uint64_t raw[block_size];
+
+	this->generator.fill(raw, block_size);
+
+	for (size_t i = 0; i < block_size; i++) {
+		// the 53 most significant bits fill the mantissa exactly
+		this->block[i] = static_cast<double>(raw[i] >> 11) * 0x1.0p-53;
+	}
+
+	this->position = 0;
+}
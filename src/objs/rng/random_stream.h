@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace rng {
+
+	constexpr unsigned lanes = 4;
+	constexpr size_t block_size = 256;
+
+	/*
+	 * Four interleaved xoshiro256+ generators.
+	 * The state is kept lane-wise so every step of the generator is a single vector operation
+	 */
+	class xoshiro256_lanes {
+		private:
+		#if defined(__GNUC__)
+			typedef uint64_t state_t __attribute__((vector_size(lanes*sizeof(uint64_t))));
+		#else
+			struct state_t { uint64_t lane[lanes]; };
+		#endif
+			state_t s0, s1, s2, s3;
+
+		public:
+			xoshiro256_lanes();
+			explicit xoshiro256_lanes(uint64_t seed);
+
+			void seed(uint64_t seed);
+
+			// writes size raw 64 bit numbers to output, size must be a multiple of lanes
+			void fill(uint64_t *output, size_t size);
+			uint64_t next();
+	};
+
+	// Integers uniformly distributed in [0, bound), generated block_size at a time using Lemire's multiply-shift reduction
+	class bounded_stream {
+		private:
+			xoshiro256_lanes generator;
+			uint32_t bound;
+			uint32_t rejection_threshold;
+			size_t position;
+			uint32_t block[block_size];
+
+			void refill();
+		public:
+			// throws invalid_argument when bound is 0 or does not fit in 32 bits
+			explicit bounded_stream(size_t bound);
+
+			inline uint32_t operator()() {
+				if (this->position == block_size) {
+					this->refill();
+				}
+				return this->block[this->position++];
+			}
+	};
+
+	// Doubles uniformly distributed in [0, 1), generated block_size at a time
+	class uniform_stream {
+		private:
+			xoshiro256_lanes generator;
+			size_t position;
+			double block[block_size];
+
+			void refill();
+		public:
+			uniform_stream();
+
+			inline double operator()() {
+				if (this->position == block_size) {
+					this->refill();
+				}
+				return this->block[this->position++];
+			}
+	};
+
+}
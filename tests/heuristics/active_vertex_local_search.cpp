@@ -0,0 +1,71 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when calculating the optimal timing of a vertex") {
+		test_case("optimal timing penalty should match the vertex penalty at that timing") {
+			MockGraph graph;
+			auto solution = constructRandomSolution(graph);
+			for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+				auto perturbation = optimalTiming(graph, v, solution);
+				solution[v] = perturbation.timing;
+				assert(perturbation.penalty, ==, graph.vertexPenalty(v, solution));
+			}
+		};
+
+		test_case("no timing should give a lower penalty than the optimal timing") {
+			MockGraph graph;
+			auto solution = constructRandomSolution(graph);
+			for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+				auto perturbation = optimalTiming(graph, v, solution);
+				for (TimeUnit t = 0; t < graph.getCycle(); t++) {
+					solution[v] = t;
+					assert(graph.vertexPenalty(v, solution), >=, perturbation.penalty);
+				}
+				solution[v] = perturbation.timing;
+			}
+		};
+	}
+
+	test_suite("when performing an active vertex local search") {
+		test_case("searched solution should be better than initial solution") {
+			MockGraph graph;
+			auto initialSolution = Solution(graph.getNumberOfVertices());
+			auto searchedSolution = activeVertexLocalSearch(graph, initialSolution);
+			assert(graph.totalPenalty(searchedSolution), <, graph.totalPenalty(initialSolution));
+		};
+
+		test_case("no vertex of the searched solution should have an improving move") {
+			MockGraph graph;
+			auto searchedSolution = activeVertexLocalSearch(graph, constructRandomSolution(graph));
+			for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+				assert(optimalTiming(graph, v, searchedSolution).penalty, >=, graph.vertexPenalty(v, searchedSolution));
+			}
+		};
+
+		test_case("search should stop when the stop function is met") {
+			MockGraph graph;
+			unsigned numberOfCalls = 0;
+			activeVertexLocalSearch(graph, Solution(graph.getNumberOfVertices()), [&](const Metrics& metrics) {
+				numberOfCalls++;
+				return metrics.numberOfIterations < 2;
+			});
+			assert(numberOfCalls, <=, 3u);
+		};
+
+		test_case("searched solution should have all timings in the interval [0, cycle)") {
+			MockGraph graph;
+			auto searchedSolution = activeVertexLocalSearch(graph, constructRandomSolution(graph));
+			for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+				assert(searchedSolution[v], >=, 0);
+				assert(searchedSolution[v], <, graph.getCycle());
+			}
+		};
+	}
+};
@@ -0,0 +1,57 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+#define NUMBER_OF_THREADS 4
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when performing asynchronous scatter search") {
+		test_case("should throw error when the elite population is empty") {
+			MockGraph graph;
+			bool exception_raised = false;
+			try {
+				heuristic::parallel::asynchronousScatterSearch(graph, 0, 4, 1, stop_function_factory::numberOfIterations(1), combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS);
+			} catch(invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+
+		test_case("population sizes should not depend on the number of threads") {
+			MockGraph graph;
+			auto searchedSolution = heuristic::parallel::asynchronousScatterSearch(graph, 3, 4, 10, stop_function_factory::numberOfIterations(3), combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS);
+			assert(searchedSolution.size(), ==, graph.getNumberOfVertices());
+		};
+
+		test_case("scatter search solution should be better than solution with 0 timings") {
+			MockGraph graph;
+			Solution zeroTimingSolution(graph.getNumberOfVertices());
+
+			auto stopFunction = stop_function_factory::numberOfIterations(3);
+			auto combinationMethod = combination_method_factory::breadthFirstSearch(0.2);
+
+			auto searchedSolution = heuristic::parallel::asynchronousScatterSearch(graph, NUMBER_OF_THREADS, NUMBER_OF_THREADS*3, 10, stopFunction, combinationMethod, NUMBER_OF_THREADS);
+
+			assert(graph.totalPenalty(searchedSolution), <, graph.totalPenalty(zeroTimingSolution));
+		};
+
+		test_case("scatter search solution should have all timings in the interval [0, cycle)") {
+			MockGraph graph;
+			auto stopFunction = stop_function_factory::numberOfIterations(3);
+			auto combinationMethod = combination_method_factory::breadthFirstSearch(0.2);
+
+			auto searchedSolution = heuristic::parallel::asynchronousScatterSearch(graph, NUMBER_OF_THREADS, NUMBER_OF_THREADS*3, 10, stopFunction, combinationMethod, NUMBER_OF_THREADS);
+
+			for (Vertex v = 0; v < searchedSolution.size(); v++) {
+				auto timing = searchedSolution[v];
+				assert(timing, >=, 0);
+				assert(timing, <, graph.getCycle());
+			}
+		};
+	}
+};
@@ -0,0 +1,74 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include <random>
+#include <vector>
+
+// not a multiple of any vector width, so the scalar tail is exercised too
+#define NUMBER_OF_TIMINGS 1000
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+template<typename T>
+pair<vector<T>, vector<T>> randomTimingsFixture(TimeUnit cycle) {
+	mt19937 randomEngine(cycle);
+	uniform_int_distribution<TimeUnit> timing(0, cycle-1);
+	vector<T> a(NUMBER_OF_TIMINGS), b(NUMBER_OF_TIMINGS);
+	for (size_t i = 0; i < NUMBER_OF_TIMINGS; i++) {
+		a[i] = timing(randomEngine);
+		b[i] = timing(randomEngine);
+	}
+	return {a, b};
+}
+
+template<typename T>
+TimeUnit expectedDistance(const vector<T>& a, const vector<T>& b, TimeUnit cycle) {
+	TimeUnit totalDistance = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		TimeUnit clockwiseDistance = abs((TimeUnit) a[i] - (TimeUnit) b[i]);
+		totalDistance += min(clockwiseDistance, cycle - clockwiseDistance);
+	}
+	return totalDistance;
+}
+
+tests {
+	test_suite("when calculating circular distances between timing arrays") {
+		test_case("32 bit timings should match the scalar definition") {
+			for (TimeUnit cycle : {2, 60, 1000, 100000}) {
+				auto [a, b] = randomTimingsFixture<int32_t>(cycle);
+				assert(circularDistance(a.data(), b.data(), a.size(), cycle), ==, expectedDistance(a, b, cycle));
+			}
+		};
+
+		test_case("16 bit timings should match the scalar definition up to a cycle of 2^16") {
+			for (TimeUnit cycle : {2, 60, 1000, 40000, 65536}) {
+				auto [a, b] = randomTimingsFixture<uint16_t>(cycle);
+				assert(circularDistance(a.data(), b.data(), a.size(), cycle), ==, expectedDistance(a, b, cycle));
+			}
+		};
+
+		test_case("16 bit timings half a cycle of 2^16 apart should be 2^15 apart") {
+			vector<uint16_t> a(NUMBER_OF_TIMINGS, 0), b(NUMBER_OF_TIMINGS, 32768);
+			assert(circularDistance(a.data(), b.data(), a.size(), 65536), ==, 32768*NUMBER_OF_TIMINGS);
+		};
+
+		test_case("8 bit timings half a cycle of 2^8 apart should be 2^7 apart") {
+			vector<uint8_t> a(NUMBER_OF_TIMINGS, 0), b(NUMBER_OF_TIMINGS, 128);
+			assert(circularDistance(a.data(), b.data(), a.size(), 256), ==, 128*NUMBER_OF_TIMINGS);
+		};
+
+		test_case("8 bit timings should match the scalar definition up to a cycle of 2^8") {
+			for (TimeUnit cycle : {2, 60, 200, 256}) {
+				auto [a, b] = randomTimingsFixture<uint8_t>(cycle);
+				assert(circularDistance(a.data(), b.data(), a.size(), cycle), ==, expectedDistance(a, b, cycle));
+			}
+		};
+
+		test_case("arrays shorter than a vector should be handled") {
+			auto [a, b] = randomTimingsFixture<uint8_t>(60);
+			assert(circularDistance(a.data(), b.data(), 5, 60), ==, expectedDistance(vector<uint8_t>(a.begin(), a.begin()+5), vector<uint8_t>(b.begin(), b.begin()+5), 60));
+		};
+	}
+};
@@ -0,0 +1,132 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when combining into an output solution") {
+		test_case("breadth first search should reuse the buffer of an output of the right size") {
+			MockGraph graph;
+			CombinationWorkspace workspace(0);
+			auto a = constructRandomSolution(graph);
+			auto b = constructRandomSolution(graph);
+			Solution output(graph.getNumberOfVertices());
+			auto buffer = output.data();
+
+			auto combineByBfs = combination_method_factory::breadthFirstSearch(0.0);
+			for (unsigned i = 0; i < 100; i++) {
+				combineByBfs(graph, a, b, output, workspace);
+				assert(output.data() == buffer, ==, true);
+			}
+		};
+
+		test_case("breadth first search should take every timing from one of the parents across repeated searches") {
+			MockGraph graph;
+			CombinationWorkspace workspace(0);
+			auto a = constructRandomSolution(graph);
+			auto b = constructRandomSolution(graph);
+			Solution output;
+
+			auto combineByBfs = combination_method_factory::breadthFirstSearch(0.0);
+			for (unsigned i = 0; i < 100; i++) {
+				combineByBfs(graph, a, b, output, workspace);
+				assert(output.size(), ==, graph.getNumberOfVertices());
+				for (Vertex v = 0; v < output.size(); v++) {
+					assert(output[v] == a[v] || output[v] == b[v], ==, true);
+				}
+			}
+		};
+
+		test_case("crossover should reuse the buffer of an output of the right size") {
+			MockGraph graph;
+			CombinationWorkspace workspace(0);
+			auto a = constructRandomSolution(graph);
+			Solution output(graph.getNumberOfVertices());
+			auto buffer = output.data();
+
+			combination_method_factory::crossover(0.0)(graph, a, a, output, workspace);
+
+			assert(output.data() == buffer, ==, true);
+			assert(output == a, ==, true);
+		};
+
+		test_case("functions returning a new solution should be adapted to write into the output") {
+			MockGraph graph;
+			CombinationWorkspace workspace(0);
+			Solution a(graph.getNumberOfVertices(), 1), b(graph.getNumberOfVertices(), 2), output;
+
+			CombinationMethod takeSecond = [](const Graph&, const Solution&, const Solution& b) -> Solution {
+				return b;
+			};
+			takeSecond(graph, a, b, output, workspace);
+
+			assert(output == b, ==, true);
+			assert(takeSecond(graph, a, b) == b, ==, true);
+		};
+	}
+
+	test_suite("when precomputing breadth-first orders") {
+		test_case("every order should split the vertices of a connected graph in halves") {
+			MockGraph graph;
+			BreadthFirstSearchOrders orders(graph, 8, 2);
+
+			assert(orders.size(), ==, 8);
+			for (size_t order = 0; order < orders.size(); order++) {
+				size_t numberOfFirst = 0, numberOfSecond = 0;
+				for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+					numberOfFirst += orders.sidesOf(order)[v] == BreadthFirstSearchOrders::FIRST;
+					numberOfSecond += orders.sidesOf(order)[v] == BreadthFirstSearchOrders::SECOND;
+				}
+				assert(numberOfFirst, ==, (graph.getNumberOfVertices()+1)/2);
+				assert(numberOfSecond, ==, graph.getNumberOfVertices()/2);
+			}
+		};
+
+		test_case("combining with precomputed orders should take every timing from the parent of its side") {
+			MockGraph graph;
+			CombinationWorkspace workspace(0);
+			auto orders = make_shared<const BreadthFirstSearchOrders>(graph, 4);
+			Solution a(graph.getNumberOfVertices(), 1), b(graph.getNumberOfVertices(), 2), output;
+
+			auto combineByBfs = combination_method_factory::breadthFirstSearch(0.0, orders);
+			for (unsigned i = 0; i < 20; i++) {
+				combineByBfs(graph, a, b, output, workspace);
+				bool matchesAnOrder = false;
+				for (size_t order = 0; order < orders->size() && !matchesAnOrder; order++) {
+					bool matches = true;
+					for (Vertex v = 0; v < output.size(); v++) {
+						matches = matches && output[v] == (orders->sidesOf(order)[v] == BreadthFirstSearchOrders::FIRST ? 1 : 2);
+					}
+					matchesAnOrder = matches;
+				}
+				assert(matchesAnOrder, ==, true);
+			}
+		};
+
+		test_case("other graphs should still be combined by traversing them") {
+			MockGraph graph, otherGraph;
+			auto orders = make_shared<const BreadthFirstSearchOrders>(graph, 4);
+			auto solution = constructRandomSolution(otherGraph);
+
+			auto combinedSolution = combination_method_factory::breadthFirstSearch(0.0, orders)(otherGraph, solution, solution);
+
+			assert(orders->isOrderOf(otherGraph), ==, false);
+			assert(combinedSolution == solution, ==, true);
+		};
+
+		test_case("no orders should throw invalid_argument") {
+			MockGraph graph;
+			bool exception_raised = false;
+			try {
+				BreadthFirstSearchOrders orders(graph, 0);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+};
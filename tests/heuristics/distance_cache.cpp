@@ -0,0 +1,140 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+#define ELITE_POPULATION_SIZE 2
+#define DIVERSE_POPULATION_SIZE 4
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+Population<Individual> randomPopulationFixture(const Graph& graph, size_t size) {
+	Population<Individual> population(size);
+	for (size_t i = 0; i < size; i++) {
+		population[i].solution = constructRandomSolution(graph);
+		population[i].penalty = graph.totalPenalty(population[i].solution);
+		population[i].id = i;
+	}
+	return population;
+}
+
+tests {
+	test_suite("when caching distances between individuals") {
+		test_case("cached distance should be equal to the distance between the solutions") {
+			MockGraph graph;
+			auto population = randomPopulationFixture(graph, 3);
+			DistanceCache distanceCache(population.size());
+
+			for (size_t i = 0; i < population.size(); i++) {
+				for (size_t j = 0; j < population.size(); j++) {
+					auto expectedDistance = distance(graph, population[i].solution, population[j].solution);
+					assert(distanceCache.distance(graph, population[i], population[j]), ==, expectedDistance);
+					assert(distanceCache.distance(graph, population[j], population[i]), ==, expectedDistance);
+				}
+			}
+		};
+
+		test_case("distance should be recalculated after the individual is invalidated") {
+			MockGraph graph;
+			auto population = randomPopulationFixture(graph, 2);
+			DistanceCache distanceCache(population.size());
+
+			distanceCache.distance(graph, population[0], population[1]);
+			population[1].solution = Solution(graph.getNumberOfVertices(), 0);
+			population[0].solution = Solution(graph.getNumberOfVertices(), testCycle/2);
+			distanceCache.invalidate(population[1].id);
+
+			assert(distanceCache.distance(graph, population[0], population[1]), ==, (TimeUnit) graph.getNumberOfVertices()*(testCycle/2));
+		};
+
+		test_case("diversify should choose the same individuals with and without the cache") {
+			MockGraph graph;
+			auto totalPopulationSize = scatterSearchPopulationSize(ELITE_POPULATION_SIZE, DIVERSE_POPULATION_SIZE);
+			auto uncachedPopulation = randomPopulationFixture(graph, totalPopulationSize);
+			auto cachedPopulation = uncachedPopulation;
+			DistanceCache distanceCache(totalPopulationSize);
+
+			ScatterSearchPopulation<Individual> uncached(uncachedPopulation, ELITE_POPULATION_SIZE, DIVERSE_POPULATION_SIZE);
+			ScatterSearchPopulation<Individual> cached(cachedPopulation, ELITE_POPULATION_SIZE, DIVERSE_POPULATION_SIZE);
+
+			// the second pass finds most distances in the cache
+			for (auto iteration = 0; iteration < 2; iteration++) {
+				auto uncachedLowestDistance = diversify(graph, uncached);
+				auto cachedLowestDistance = diversify(graph, cached, distanceCache);
+				assert(cachedLowestDistance, ==, uncachedLowestDistance);
+				for (size_t i = 0; i < totalPopulationSize; i++) {
+					assert(cachedPopulation[i].id, ==, uncachedPopulation[i].id);
+				}
+			}
+		};
+	}
+
+	test_suite("when sketching distances between individuals") {
+		test_case("sketch of size 0 or covering every vertex should be exact") {
+			MockGraph graph;
+			assert(DistanceSketch(graph, 0).isExact(), ==, true);
+			assert(DistanceSketch(graph, graph.getNumberOfVertices()).isExact(), ==, true);
+			assert(DistanceSketch(graph, graph.getNumberOfVertices()-1).isExact(), ==, false);
+		};
+
+		test_case("estimated distance should be scaled to the whole graph") {
+			MockGraph graph;
+			DistanceSketch distanceSketch(graph, 2);
+			Individual a, b;
+			// with uniform timings every sample sees the same distance, whichever vertices are sampled
+			a.solution = Solution(graph.getNumberOfVertices(), 1);
+			b.solution = Solution(graph.getNumberOfVertices(), testCycle-2);
+			distanceSketch.update(a);
+			distanceSketch.update(b);
+
+			assert(distanceSketch.estimatedDistance(a, a), ==, 0);
+			assert(distanceSketch.estimatedDistance(a, b), ==, distance(graph, a.solution, b.solution));
+		};
+
+		test_case("refined minimum distance should be exact even when the recorded estimate is far from every sketched distance") {
+			MockGraph graph;
+			auto selected = randomPopulationFixture(graph, 3);
+			Individual individual;
+			individual.solution = Solution(graph.getNumberOfVertices(), testCycle/2);
+			individual.id = selected.size();
+			DistanceCache distanceCache(selected.size()+1);
+			DistanceSketch distanceSketch(graph, 2);
+			for (auto& selectedIndividual : selected) {
+				distanceSketch.update(selectedIndividual);
+			}
+			distanceSketch.update(individual);
+			// a stale estimate, lower than any distance the sketch measures
+			individual.minimumDistance = individual.estimatedMinimumDistance = 0;
+
+			TimeUnit expectedDistance = numeric_limits<TimeUnit>::max();
+			for (auto& selectedIndividual : selected) {
+				expectedDistance = min(expectedDistance, distance(graph, individual.solution, selectedIndividual.solution));
+			}
+			auto refinedDistance = refineMinimumDistance(graph, individual, selected.begin(), selected.end(), distanceCache, distanceSketch);
+			assert(refinedDistance, !=, numeric_limits<TimeUnit>::max());
+			assert(refinedDistance, >=, expectedDistance);
+		};
+
+		test_case("diversify with sketched distances should keep every individual exactly once") {
+			MockGraph graph;
+			auto totalPopulationSize = scatterSearchPopulationSize(ELITE_POPULATION_SIZE, DIVERSE_POPULATION_SIZE);
+			auto totalPopulation = randomPopulationFixture(graph, totalPopulationSize);
+			DistanceCache distanceCache(totalPopulationSize);
+			DistanceSketch distanceSketch(graph, 3);
+			for (auto& individual : totalPopulation) {
+				distanceSketch.update(individual);
+			}
+
+			ScatterSearchPopulation<Individual> population(totalPopulation, ELITE_POPULATION_SIZE, DIVERSE_POPULATION_SIZE);
+			diversify(graph, population, distanceCache, distanceSketch);
+
+			vector<bool> isPresent(totalPopulationSize, false);
+			for (auto& individual : totalPopulation) {
+				assert(isPresent[individual.id], ==, false);
+				isPresent[individual.id] = true;
+			}
+		};
+	}
+};
@@ -0,0 +1,117 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include <heuristic/parallel_scatter_search.h>
+#include <parallel/reusable_thread.h>
+#include <memory>
+#include <random>
+#include <algorithm>
+
+#define NUMBER_OF_THREADS 4
+#define EXCHANGE_GRAPH_VERTICES 40
+#define EXCHANGE_ELITE_SIZE 4
+#define EXCHANGE_DIVERSE_SIZE 6
+#define EXCHANGE_DISCARDED_SIZE 12
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+// ring with chords, whose random weights and timings make ties between penalties and distances unlikely
+AdjacencyListGraph* exchangeGraphFixture(void) {
+	mt19937 randomEngine(0);
+	GraphBuilder graphBuilder;
+	for (Vertex v = 0; v < EXCHANGE_GRAPH_VERTICES; v++) {
+		graphBuilder.addEdge(Graph::Edge{v, (v+1)%EXCHANGE_GRAPH_VERTICES}, randomEngine()%1000);
+		graphBuilder.addEdge(Graph::Edge{v, (v+7)%EXCHANGE_GRAPH_VERTICES}, randomEngine()%1000);
+	}
+	graphBuilder.withCycle(1000);
+	return graphBuilder.buildAsAdjacencyList();
+}
+
+Individual exchangeIndividualFixture(const Graph& graph, size_t id) {
+	mt19937 randomEngine(id);
+	Individual individual;
+	individual.solution = Solution(graph.getNumberOfVertices());
+	for (auto& timing : individual.solution) {
+		timing = randomEngine()%graph.getCycle();
+	}
+	individual.penalty = graph.totalPenalty(individual.solution);
+	individual.id = id;
+	return individual;
+}
+
+// exchange as it was done before heaps, rescanning every set with min_element and max_element after each swap
+void referenceExchange(const Graph& graph, ScatterSearchPopulation<Individual>& population, Population<Individual>& discardedPopulation, DistanceCache& distanceCache) {
+	auto lowestPenalty = [](const Individual& a, const Individual& b) { return a.penalty < b.penalty; };
+	auto smallestMinimumDistance = [](const Individual& a, const Individual& b) { return a.minimumDistance < b.minimumDistance; };
+
+	for (auto& eliteIndividual : population.elite) {
+		auto bestDiscardedIndividual = min_element(discardedPopulation.begin(), discardedPopulation.end(), lowestPenalty);
+		if (eliteIndividual.penalty > bestDiscardedIndividual->penalty) {
+			swap(eliteIndividual, *bestDiscardedIndividual);
+		}
+	}
+
+	for (auto& discardedIndividual : discardedPopulation) {
+		discardedIndividual.minimumDistance = numeric_limits<TimeUnit>::max();
+		for (auto& eliteIndividual : population.elite) {
+			discardedIndividual.minimumDistance = min(discardedIndividual.minimumDistance, distanceCache.distance(graph, eliteIndividual, discardedIndividual));
+		}
+	}
+
+	for (auto diverseIndividual = population.diverse.begin(); diverseIndividual < population.diverse.end(); diverseIndividual++) {
+		auto bestDiverseIndividual = max_element(diverseIndividual, population.diverse.end(), smallestMinimumDistance);
+		auto bestDiscardedIndividual = max_element(discardedPopulation.begin(), discardedPopulation.end(), smallestMinimumDistance);
+		if (bestDiverseIndividual->minimumDistance > bestDiscardedIndividual->minimumDistance) {
+			iter_swap(diverseIndividual, bestDiverseIndividual);
+		} else {
+			iter_swap(diverseIndividual, bestDiscardedIndividual);
+		}
+		for (auto& discardedIndividual : discardedPopulation) {
+			discardedIndividual.minimumDistance = min(discardedIndividual.minimumDistance, distanceCache.distance(graph, *diverseIndividual, discardedIndividual));
+		}
+	}
+}
+
+tests {
+	test_suite("when exchanging discarded individuals with a population") {
+		test_case("discarded individuals should be exchanged like a rescan of every set after each swap would") {
+			unique_ptr<AdjacencyListGraph> graph(exchangeGraphFixture());
+			auto totalPopulationSize = scatterSearchPopulationSize(EXCHANGE_ELITE_SIZE, EXCHANGE_DIVERSE_SIZE);
+			DistanceSketch exactDistances(*graph, 0);
+
+			for (unsigned numberOfThreads : {1u, (unsigned) NUMBER_OF_THREADS}) {
+				Population<Individual> totalPopulation, discardedPopulation;
+				for (size_t id = 0; id < totalPopulationSize; id++) {
+					totalPopulation.push_back(exchangeIndividualFixture(*graph, id));
+				}
+				for (size_t id = totalPopulationSize; id < totalPopulationSize+EXCHANGE_DISCARDED_SIZE; id++) {
+					discardedPopulation.push_back(exchangeIndividualFixture(*graph, id));
+				}
+				DistanceCache distanceCache(totalPopulationSize+EXCHANGE_DISCARDED_SIZE);
+				vector<ScatterSearchPopulation<Individual>> populations = {ScatterSearchPopulation<Individual>(totalPopulation, EXCHANGE_ELITE_SIZE, EXCHANGE_DIVERSE_SIZE)};
+				// gives the diverse individuals the minimum distances they carry into an exchange
+				diversify(*graph, populations[0], distanceCache);
+
+				auto expectedTotalPopulation = totalPopulation;
+				auto expectedDiscardedPopulation = discardedPopulation;
+				ScatterSearchPopulation<Individual> expectedPopulation(expectedTotalPopulation, EXCHANGE_ELITE_SIZE, EXCHANGE_DIVERSE_SIZE);
+				referenceExchange(*graph, expectedPopulation, expectedDiscardedPopulation, distanceCache);
+
+				::parallel::thread_pile threads(numberOfThreads);
+				::parallel::thread_pile::slice_t availableThreads = threads;
+				heuristic::parallel::exchangeDiscardedIndividuals(*graph, populations, 0, 1, discardedPopulation, distanceCache, exactDistances, availableThreads);
+
+				for (size_t i = 0; i < EXCHANGE_ELITE_SIZE+EXCHANGE_DIVERSE_SIZE; i++) {
+					assert(populations[0].reference[i].id, ==, expectedPopulation.reference[i].id);
+				}
+				// the fixture only checks something if discarded individuals make it into both sets
+				auto isDiscarded = [&](const Individual& individual) { return individual.id >= totalPopulationSize; };
+				assert(any_of(populations[0].elite.begin(), populations[0].elite.end(), isDiscarded), ==, true);
+				assert(any_of(populations[0].diverse.begin(), populations[0].diverse.end(), isDiscarded), ==, true);
+			}
+		};
+
+	}
+};
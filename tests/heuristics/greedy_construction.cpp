@@ -0,0 +1,46 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when constructing greedy initial solution") {
+		test_case("solution should have one timing per vertex") {
+			MockGraph graph;
+			auto solution = constructGreedySolution(graph);
+			assert(solution.size(), ==, graph.getNumberOfVertices());
+		};
+
+		test_case("solution should have all timings in the interval [0, cycle)") {
+			MockGraph graph;
+			auto solution = constructGreedySolution(graph);
+			for (Vertex i = 0; i < graph.getNumberOfVertices(); i++) {
+				auto timing = solution[i];
+				assert((timing >= 0 && timing < testCycle), ==, true);
+			}
+		};
+
+		test_case("solution should be better than solution with 0 timings") {
+			MockGraph graph;
+			Solution zeroTimingSolution(graph.getNumberOfVertices());
+			auto solution = constructGreedySolution(graph);
+			assert(graph.totalPenalty(solution), <, graph.totalPenalty(zeroTimingSolution));
+		};
+
+		test_case("optimal timing against assigned neighbors should ignore unassigned neighbors") {
+			MockGraph graph;
+			Solution solution(graph.getNumberOfVertices(), 0);
+			vector<bool> isAssigned(graph.getNumberOfVertices(), false);
+			isAssigned[1] = true;
+			solution[1] = 5;
+			// only the edge 0-1 of weight 7 is considered: its anchors 18 and 12 are 6 apart, and both are optimal
+			auto perturbation = optimalTiming(graph, 0, solution, isAssigned);
+			assert(perturbation.penalty, ==, 6);
+			assert((perturbation.timing == 18 || perturbation.timing == 12), ==, true);
+		};
+	}
+};
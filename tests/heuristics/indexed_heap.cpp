@@ -0,0 +1,108 @@
+#include <assertions-test/test.h>
+#include <heuristic/indexed_heap.h>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <limits>
+
+#define NUMBER_OF_ITEMS 50
+
+using namespace std;
+using namespace heuristic;
+
+// top must be an item with the greatest key, and every item must be popped exactly once
+template<typename Heap>
+void assertPopsInOrder(Heap& heap, const vector<int>& keys, size_t expectedNumberOfItems) {
+	vector<bool> popped(keys.size(), false);
+	int previousKey = numeric_limits<int>::max();
+	for (size_t n = 0; n < expectedNumberOfItems; n++) {
+		auto item = heap.top();
+		assert(popped[item], ==, false);
+		assert(keys[item], <=, previousKey);
+		popped[item] = true;
+		previousKey = keys[item];
+		heap.remove(item);
+	}
+	assert(heap.size(), ==, 0);
+}
+
+tests {
+	test_suite("when keeping items in an indexed heap") {
+		test_case("items should come out of the top in order of their keys") {
+			mt19937 randomEngine(0);
+			vector<int> keys(NUMBER_OF_ITEMS);
+			for (auto& key : keys) {
+				key = randomEngine()%20;
+			}
+			auto heap = indexedHeap(keys.size(), [&](size_t a, size_t b) { return keys[a] > keys[b]; });
+			for (size_t item = 0; item < keys.size(); item++) {
+				heap.push(item);
+			}
+
+			assert(heap.size(), ==, NUMBER_OF_ITEMS);
+			assertPopsInOrder(heap, keys, NUMBER_OF_ITEMS);
+		};
+
+		test_case("updated keys should be sifted back into place") {
+			mt19937 randomEngine(1);
+			vector<int> keys(NUMBER_OF_ITEMS);
+			for (auto& key : keys) {
+				key = randomEngine()%1000;
+			}
+			auto heap = indexedHeap(keys.size(), [&](size_t a, size_t b) { return keys[a] > keys[b]; });
+			for (size_t item = 0; item < keys.size(); item++) {
+				heap.push(item);
+			}
+
+			// both raised and lowered keys, including those of the top
+			for (size_t n = 0; n < NUMBER_OF_ITEMS; n++) {
+				auto item = n%3 == 0 ? heap.top() : randomEngine()%NUMBER_OF_ITEMS;
+				keys[item] = randomEngine()%1000;
+				heap.update(item);
+				assert(keys[heap.top()], ==, *max_element(keys.begin(), keys.end()));
+			}
+			assertPopsInOrder(heap, keys, NUMBER_OF_ITEMS);
+		};
+
+		test_case("removing items anywhere should keep the others in order") {
+			vector<int> keys(NUMBER_OF_ITEMS);
+			for (size_t item = 0; item < keys.size(); item++) {
+				keys[item] = (item*37)%NUMBER_OF_ITEMS;
+			}
+			auto heap = indexedHeap(keys.size(), [&](size_t a, size_t b) { return keys[a] > keys[b]; });
+			for (size_t item = 0; item < keys.size(); item++) {
+				heap.push(item);
+			}
+
+			for (size_t item = 0; item < keys.size(); item += 2) {
+				heap.remove(item);
+			}
+			assert(heap.size(), ==, NUMBER_OF_ITEMS/2);
+
+			vector<int> remainingKeys(keys.size(), numeric_limits<int>::min());
+			for (size_t item = 1; item < keys.size(); item += 2) {
+				remainingKeys[item] = keys[item];
+			}
+			assertPopsInOrder(heap, remainingKeys, NUMBER_OF_ITEMS/2);
+		};
+
+		test_case("relabeled items should keep their place and be found by their new label") {
+			vector<int> keys = {5, 9, 1, 0};
+			auto heap = indexedHeap(keys.size(), [&](size_t a, size_t b) { return keys[a] > keys[b]; });
+			heap.push(0);
+			heap.push(1);
+			heap.push(2);
+
+			// item 1 moves to index 3, with the same key
+			keys[3] = keys[1];
+			heap.relabel(1, 3);
+			assert(heap.top(), ==, 3);
+
+			keys[3] = 0;
+			heap.update(3);
+			assert(heap.top(), ==, 0);
+			heap.remove(0);
+			assert(heap.top(), ==, 2);
+		};
+	}
+};
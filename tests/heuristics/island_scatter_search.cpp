@@ -0,0 +1,195 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define NUMBER_OF_THREADS 2
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+// sends every emigrant back to its own island, along with one migrant of the wrong size
+class LoopbackTransport : public MigrationTransport {
+	public:
+		vector<Solution> inbox;
+		size_t numberOfSends = 0;
+
+		void send (const vector<Solution>& emigrants) override {
+			this->numberOfSends++;
+			this->inbox.insert(this->inbox.end(), emigrants.begin(), emigrants.end());
+			this->inbox.push_back(Solution(1, 0));
+		}
+
+		vector<Solution> receive (void) override {
+			vector<Solution> received;
+			received.swap(this->inbox);
+			return received;
+		}
+};
+
+string testSocketPath (const string& name) {
+	return "/tmp/traffic_test_" + to_string(getpid()) + "_" + name + ".sock";
+}
+
+// receives until at least minimumNumberOfMigrants arrived, or two seconds went by
+vector<Solution> receiveMigrants (MigrationTransport& transport, size_t minimumNumberOfMigrants) {
+	vector<Solution> received;
+	for (unsigned attempt = 0; attempt < 200 && received.size() < minimumNumberOfMigrants; attempt++) {
+		auto arrived = transport.receive();
+		received.insert(received.end(), arrived.begin(), arrived.end());
+		usleep(10000);
+	}
+	return received;
+}
+
+tests {
+	test_suite("when carrying migrants over Unix domain sockets") {
+		test_case("migrants sent to a neighbor should be received by it") {
+			UnixSocketTransport receiver(testSocketPath("receiver"), {});
+			UnixSocketTransport sender(testSocketPath("sender"), {testSocketPath("receiver")});
+			vector<Solution> emigrants = {{1, 2, 3}, {4, 5, 6}};
+
+			sender.send(emigrants);
+
+			assert(receiveMigrants(receiver, emigrants.size()) == emigrants, ==, true);
+		};
+
+		test_case("a neighbor stalling mid-message should not delay the migrants of the others") {
+			UnixSocketTransport receiver(testSocketPath("busy"), {});
+			UnixSocketTransport sender(testSocketPath("prompt"), {testSocketPath("busy")});
+			vector<Solution> emigrants = {{1, 2, 3}};
+
+			// a connection that only ever writes half of its header
+			sockaddr_un address;
+			memset(&address, 0, sizeof(address));
+			address.sun_family = AF_UNIX;
+			strncpy(address.sun_path, testSocketPath("busy").c_str(), sizeof(address.sun_path)-1);
+			int stalledConnection = socket(AF_UNIX, SOCK_STREAM, 0);
+			assert(connect(stalledConnection, reinterpret_cast<sockaddr*>(&address), sizeof(address)), ==, 0);
+			uint16_t halfHeader = 1;
+			assert(write(stalledConnection, &halfHeader, sizeof(halfHeader)), ==, (ssize_t) sizeof(halfHeader));
+
+			auto begin = chrono::steady_clock::now();
+			sender.send(emigrants);
+			auto received = receiveMigrants(receiver, emigrants.size());
+			close(stalledConnection);
+
+			assert(received == emigrants, ==, true);
+			// well before the stalled connection would time out
+			assert(chrono::steady_clock::now() - begin < chrono::seconds(2), ==, true);
+		};
+
+		test_case("a neighbor that never reads should not block the migrants of the others for good") {
+			UnixSocketTransport receiver(testSocketPath("reading"), {});
+			UnixSocketTransport sender(testSocketPath("writing"), {testSocketPath("deaf"), testSocketPath("reading")});
+			// far more than the socket buffers hold
+			vector<Solution> emigrants(16, Solution(1 << 18, 1));
+
+			// a neighbor that accepts the connection and never reads from it
+			sockaddr_un address;
+			memset(&address, 0, sizeof(address));
+			address.sun_family = AF_UNIX;
+			strncpy(address.sun_path, testSocketPath("deaf").c_str(), sizeof(address.sun_path)-1);
+			int deafSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+			assert(bind(deafSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)), ==, 0);
+			assert(::listen(deafSocket, 1), ==, 0);
+			int deafConnection = -1;
+			thread acceptor([&]() { deafConnection = accept(deafSocket, nullptr, nullptr); });
+
+			auto begin = chrono::steady_clock::now();
+			sender.send(emigrants);
+			auto elapsed = chrono::steady_clock::now() - begin;
+			auto received = receiveMigrants(receiver, emigrants.size());
+
+			acceptor.join();
+			close(deafConnection);
+			close(deafSocket);
+			unlink(testSocketPath("deaf").c_str());
+
+			assert(elapsed < chrono::seconds(10), ==, true);
+			assert(received == emigrants, ==, true);
+		};
+
+		test_case("should throw error instead of removing a file that is not a socket") {
+			auto path = testSocketPath("regular");
+			ofstream(path) << "not a socket";
+
+			bool exception_raised = false;
+			try {
+				UnixSocketTransport transport(path, {});
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			bool fileKept = access(path.c_str(), F_OK) == 0;
+			unlink(path.c_str());
+
+			assert(exception_raised, ==, true);
+			assert(fileKept, ==, true);
+		};
+
+		test_case("inbox should keep only the most recent migrants beyond its capacity") {
+			UnixSocketTransport receiver(testSocketPath("small"), {}, 2);
+			UnixSocketTransport sender(testSocketPath("large"), {testSocketPath("small")});
+
+			// migrants of a message reach the inbox together, so the first ones are already dropped when it is read
+			sender.send({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+
+			vector<Solution> mostRecent = {{4, 5, 6}, {7, 8, 9}};
+			assert(receiveMigrants(receiver, 1) == mostRecent, ==, true);
+		};
+
+		test_case("should throw error when the inbox capacity is 0") {
+			bool exception_raised = false;
+			try {
+				UnixSocketTransport receiver(testSocketPath("closed"), {}, 0);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+
+		test_case("sending to a neighbor that is not listening should drop the migrants") {
+			UnixSocketTransport sender(testSocketPath("lonely"), {testSocketPath("missing")});
+			sender.send({{1, 2, 3}});
+			assert(sender.receive().size(), ==, 0);
+		};
+	}
+
+	test_suite("when performing island scatter search") {
+		test_case("migrants should be exchanged and the solution stay within the cycle") {
+			MockGraph graph;
+			auto transport = make_shared<LoopbackTransport>();
+			parallel::IslandMigration migration = {transport, 1, 2};
+
+			auto searchedSolution = parallel::islandScatterSearch(graph, NUMBER_OF_THREADS, NUMBER_OF_THREADS*3, 10, stop_function_factory::numberOfIterations(3), combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS, migration);
+
+			assert(transport->numberOfSends, ==, 3);
+			assert(searchedSolution.size(), ==, graph.getNumberOfVertices());
+			for (Vertex v = 0; v < searchedSolution.size(); v++) {
+				assert(searchedSolution[v], >=, 0);
+				assert(searchedSolution[v], <, graph.getCycle());
+			}
+		};
+
+		test_case("should throw error when migration interval is 0") {
+			MockGraph graph;
+			parallel::IslandMigration migration = {make_shared<LoopbackTransport>(), 0, 2};
+			bool exception_raised = false;
+			try {
+				parallel::islandScatterSearch(graph, NUMBER_OF_THREADS, NUMBER_OF_THREADS*3, 10, stop_function_factory::numberOfIterations(1), combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS, migration);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+};
@@ -40,4 +40,32 @@ tests {
 			}
 		};
 	}
+
+	test_suite("when improving a solution in place") {
+		test_case("built-in improvement methods should keep the buffer of the solution") {
+			MockGraph graph;
+			for (auto& improvementMethod : {improvement_method_factory::localSearch(), improvement_method_factory::tabuSearch(3, 2), improvement_method_factory::activeVertexLocalSearch()}) {
+				auto initialSolution = Solution(graph.getNumberOfVertices());
+				auto solution = initialSolution;
+				auto buffer = solution.data();
+
+				improvementMethod.improve(graph, solution, stop_function_factory::numberOfIterations(25));
+
+				assert(solution.data() == buffer, ==, true);
+				assert(graph.totalPenalty(solution), <, graph.totalPenalty(initialSolution));
+			}
+		};
+
+		test_case("functions returning a new solution should be adapted to improve in place") {
+			MockGraph graph;
+			ImprovementMethod improvementMethod = [](const Graph&, const Solution& solution, const StopFunction&) {
+				return Solution(solution.size(), 1);
+			};
+			Solution solution(graph.getNumberOfVertices(), 0);
+
+			improvementMethod.improve(graph, solution, stop_function_factory::numberOfIterations(1));
+
+			assert(solution == Solution(graph.getNumberOfVertices(), 1), ==, true);
+		};
+	}
 };
@@ -0,0 +1,102 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+
+#define NUMBER_OF_VERTICES 300
+#define MIN_VERTEX_DEGREE 2
+#define MAX_VERTEX_DEGREE 5
+#define MIN_EDGE_WEIGHT 2
+#define MAX_EDGE_WEIGHT 13
+#define CYCLE 20
+#define COARSEST_NUMBER_OF_VERTICES 40
+#define COMPLETE_GRAPH_VERTICES 64
+#define STAR_GRAPH_VERTICES 30
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+Graph* randomGraphFixture() {
+	auto graphBuilder = GraphBuilder(NUMBER_OF_VERTICES, MIN_VERTEX_DEGREE, MAX_VERTEX_DEGREE, MIN_EDGE_WEIGHT, MAX_EDGE_WEIGHT);
+	graphBuilder.withCycle(CYCLE);
+	return graphBuilder.buildAsAdjacencyList();
+}
+
+// every maximal matching pairs all the vertices of a complete graph with an even number of them, so each level halves the graph
+Graph* completeGraphFixture() {
+	GraphBuilder graphBuilder;
+	for (Vertex v = 0; v < COMPLETE_GRAPH_VERTICES; v++) {
+		for (Vertex u = v+1; u < COMPLETE_GRAPH_VERTICES; u++) {
+			graphBuilder.addEdge(Graph::Edge{v, u}, MIN_EDGE_WEIGHT + (v+u)%(MAX_EDGE_WEIGHT-MIN_EDGE_WEIGHT));
+		}
+	}
+	graphBuilder.withCycle(CYCLE);
+	return graphBuilder.buildAsAdjacencyList();
+}
+
+// only one leaf can be matched with the center, so coarsening barely shrinks a star
+Graph* starGraphFixture() {
+	GraphBuilder graphBuilder;
+	for (Vertex leaf = 1; leaf < STAR_GRAPH_VERTICES; leaf++) {
+		graphBuilder.addEdge(Graph::Edge{0, leaf}, MIN_EDGE_WEIGHT);
+	}
+	graphBuilder.withCycle(CYCLE);
+	return graphBuilder.buildAsAdjacencyList();
+}
+
+Vertex coarsestNumberOfVerticesOf(const Graph& graph, Vertex requestedNumberOfVertices) {
+	Vertex coarsestNumberOfVertices = 0;
+	multilevelSearch(graph, requestedNumberOfVertices, [&](const Graph& coarsestGraph) -> Solution {
+		coarsestNumberOfVertices = coarsestGraph.getNumberOfVertices();
+		return constructRandomSolution(coarsestGraph);
+	});
+	return coarsestNumberOfVertices;
+}
+
+tests {
+	test_suite("when performing multilevel search") {
+		test_case("coarsest level should have at most the requested number of vertices when matchings halve the graph") {
+			auto graph = completeGraphFixture();
+			auto coarsestNumberOfVertices = coarsestNumberOfVerticesOf(*graph, COMPLETE_GRAPH_VERTICES/8);
+			assert(coarsestNumberOfVertices, <=, COMPLETE_GRAPH_VERTICES/8);
+			assert(coarsestNumberOfVertices, >, 0);
+			delete graph;
+		};
+
+		test_case("coarsening should stop early when a matching barely shrinks the graph") {
+			auto graph = starGraphFixture();
+			auto coarsestNumberOfVertices = coarsestNumberOfVerticesOf(*graph, 4);
+			assert(coarsestNumberOfVertices, ==, STAR_GRAPH_VERTICES);
+			delete graph;
+		};
+
+		test_case("solution should have all timings in the interval [0, cycle)") {
+			auto graph = randomGraphFixture();
+			auto solution = multilevelSearch(*graph, COARSEST_NUMBER_OF_VERTICES, construction_method_factory::greedySolution());
+			assert(solution.size(), ==, graph->getNumberOfVertices());
+			for (auto timing : solution) {
+				assert((timing >= 0 && timing < CYCLE), ==, true);
+			}
+			delete graph;
+		};
+
+		test_case("solution should be better than a random solution") {
+			auto graph = randomGraphFixture();
+			auto solution = multilevelSearch(*graph, COARSEST_NUMBER_OF_VERTICES, construction_method_factory::greedySolution());
+			assert(graph->totalPenalty(solution), <, graph->totalPenalty(constructRandomSolution(*graph)));
+			delete graph;
+		};
+
+		test_case("should throw error when coarsest number of vertices is smaller than 2") {
+			auto graph = randomGraphFixture();
+			bool exception_raised = false;
+			try {
+				multilevelSearch(*graph, 1, construction_method_factory::greedySolution());
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+			delete graph;
+		};
+	}
+};
@@ -0,0 +1,47 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+#define NUMBER_OF_THREADS 4
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when performing parallel multi-start local search") {
+		test_case("solution should have one timing per vertex") {
+			MockGraph graph;
+			auto solution = heuristic::parallel::multiStartLocalSearch(graph, chrono::milliseconds(20), 100, 0.1, NUMBER_OF_THREADS);
+			assert(solution.size(), ==, graph.getNumberOfVertices());
+		};
+
+		test_case("solution should be better than solution with 0 timings") {
+			MockGraph graph;
+			Solution zeroTimingSolution(graph.getNumberOfVertices());
+			auto solution = heuristic::parallel::multiStartLocalSearch(graph, chrono::milliseconds(20), 100, 0.1, NUMBER_OF_THREADS);
+			assert(graph.totalPenalty(solution), <, graph.totalPenalty(zeroTimingSolution));
+		};
+
+		test_case("search should return shortly after the time budget") {
+			MockGraph graph;
+			auto begin = chrono::high_resolution_clock::now();
+			heuristic::parallel::multiStartLocalSearch(graph, chrono::milliseconds(50), 1000, 0.0, NUMBER_OF_THREADS);
+			auto duration = chrono::high_resolution_clock::now() - begin;
+			assert(duration, >=, chrono::milliseconds(50));
+			assert(duration, <, chrono::milliseconds(500));
+		};
+
+		test_case("should throw error when number of threads is 0") {
+			MockGraph graph;
+			bool exception_raised = false;
+			try {
+				heuristic::parallel::multiStartLocalSearch(graph, chrono::milliseconds(1), 100, 0.1, 0);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+};
@@ -0,0 +1,71 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include <heuristic/parallel_scatter_search.h>
+#include <parallel/reusable_thread.h>
+#include "mock_graph.h"
+
+#define NUMBER_OF_THREADS 4
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when initializing a population in parallel") {
+		test_case("every individual of every slice should be constructed") {
+			MockGraph graph;
+			Population<Individual> population(10);
+			heuristic::parallel::initializePopulation(graph, {
+				{population.slice(0, 3), stop_function_factory::numberOfIterations(100), construction_method_factory::heuristicSolution()},
+				{population.slice(3, 10), stop_function_factory::numberOfIterations(10), construction_method_factory::spanningTreeSolution()}
+			}, NUMBER_OF_THREADS, improvement_method_factory::localSearch());
+
+			for (auto& individual : population) {
+				assert(individual.solution.size(), ==, graph.getNumberOfVertices());
+				assert(individual.penalty, ==, graph.totalPenalty(individual.solution));
+			}
+		};
+
+		test_case("individuals outside of the slices should be left untouched") {
+			MockGraph graph;
+			Population<Individual> population(6);
+			heuristic::parallel::initializePopulation(graph, {
+				{population.slice(0, 4), stop_function_factory::numberOfIterations(10), construction_method_factory::randomSolution()}
+			}, NUMBER_OF_THREADS, improvement_method_factory::localSearch());
+
+			assert(population[4].solution.size(), ==, 0);
+			assert(population[5].solution.size(), ==, 0);
+		};
+
+		test_case("every individual should be constructed on the threads of an existing pile") {
+			MockGraph graph;
+			Population<Individual> population(10);
+			::parallel::thread_pile threads(NUMBER_OF_THREADS);
+			::parallel::thread_pile::slice_t availableThreads = threads;
+			heuristic::parallel::initializePopulation(graph, {
+				{population.slice(0, 3), stop_function_factory::numberOfIterations(100), construction_method_factory::heuristicSolution()},
+				{population.slice(3, 10), stop_function_factory::numberOfIterations(10), construction_method_factory::randomSolution()}
+			}, availableThreads, improvement_method_factory::localSearch());
+
+			for (auto& individual : population) {
+				assert(individual.solution.size(), ==, graph.getNumberOfVertices());
+				assert(individual.penalty, ==, graph.totalPenalty(individual.solution));
+			}
+		};
+
+		test_case("should throw error when number of threads is 0") {
+			MockGraph graph;
+			Population<Individual> population(2);
+			bool exception_raised = false;
+			try {
+				heuristic::parallel::initializePopulation(graph, {
+					{population.slice(0, 2), stop_function_factory::numberOfIterations(10), construction_method_factory::randomSolution()}
+				}, 0, improvement_method_factory::localSearch());
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+};
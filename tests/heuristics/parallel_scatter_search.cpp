@@ -22,6 +22,28 @@ tests {
 			assert(exception_raised, ==, true);
 		};
 
+		test_case("a search stopped at its first check should report and return its best initial elite") {
+			MockGraph graph;
+			bool reportedSolution = false;
+			TimeUnit reportedPenalty = 0, reportedSolutionPenalty = 0;
+			for (auto topology : {heuristic::parallel::MigrationPolicy::TREE, heuristic::parallel::MigrationPolicy::RING}) {
+				heuristic::parallel::MigrationPolicy migrationPolicy;
+				migrationPolicy.topology = topology;
+				auto solution = heuristic::parallel::scatterSearch(graph, NUMBER_OF_THREADS*2, NUMBER_OF_THREADS*2, 0, [&](const Metrics& metrics) {
+					reportedSolution = metrics.solution != nullptr;
+					if (reportedSolution) {
+						reportedPenalty = metrics.penalty;
+						reportedSolutionPenalty = graph.totalPenalty(*metrics.solution);
+					}
+					return false;
+				}, combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS, improvement_method_factory::localSearch(), construction_method_factory::randomSolution(), construction_method_factory::randomSolution(), 0, migrationPolicy);
+
+				assert(reportedSolution, ==, true);
+				assert(reportedSolutionPenalty, ==, reportedPenalty);
+				assert(graph.totalPenalty(solution), ==, reportedPenalty);
+			}
+		};
+
 		test_case("scatter search solution should have at least one timing different from 0") {
 			MockGraph graph;
 			size_t elitePopulationSize = NUMBER_OF_THREADS;
@@ -79,5 +101,99 @@ tests {
 				assert(timing, <, graph.getCycle());
 			}
 		};
+
+		test_case("thread counts that do not divide the population should split it unevenly") {
+			MockGraph graph;
+			auto stopFunction = stop_function_factory::numberOfIterations(3);
+			auto combinationMethod = combination_method_factory::breadthFirstSearch(0.2);
+
+			for (unsigned numberOfThreads : {3u, 5u, 6u}) {
+				auto searchedSolution = heuristic::parallel::scatterSearch(graph, 7, 11, 10, stopFunction, combinationMethod, numberOfThreads);
+
+				assert(searchedSolution.size(), ==, graph.getNumberOfVertices());
+				for (Vertex v = 0; v < searchedSolution.size(); v++) {
+					assert(searchedSolution[v], >=, 0);
+					assert(searchedSolution[v], <, graph.getCycle());
+				}
+			}
+		};
+
+		test_case("should throw error when there are fewer elite individuals than threads") {
+			MockGraph graph;
+			bool exception_raised = false;
+			try {
+				heuristic::parallel::scatterSearch(graph, 2, 10, 1, stop_function_factory::numberOfIterations(1), combination_method_factory::breadthFirstSearch(0.2), 3);
+			} catch(invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+
+	test_suite("when exchanging individuals between threads") {
+		test_case("every topology should give a solution with all timings in the interval [0, cycle)") {
+			MockGraph graph;
+			auto combinationMethod = combination_method_factory::breadthFirstSearch(0.2);
+
+			for (auto topology : {parallel::MigrationPolicy::TREE, parallel::MigrationPolicy::RING, parallel::MigrationPolicy::HYPERCUBE, parallel::MigrationPolicy::RANDOM_PAIRS}) {
+				parallel::MigrationPolicy migrationPolicy;
+				migrationPolicy.topology = topology;
+				migrationPolicy.interval = 2;
+
+				auto searchedSolution = heuristic::parallel::scatterSearch(graph, 6, 12, 10, stop_function_factory::numberOfIterations(4), combinationMethod, 3, improvement_method_factory::localSearch(), construction_method_factory::heuristicSolution(), construction_method_factory::spanningTreeSolution(), 0, migrationPolicy);
+
+				assert(searchedSolution.size(), ==, graph.getNumberOfVertices());
+				for (Vertex v = 0; v < searchedSolution.size(); v++) {
+					assert(searchedSolution[v], >=, 0);
+					assert(searchedSolution[v], <, graph.getCycle());
+				}
+			}
+		};
+
+		test_case("pinned threads with graph replicas should find a solution within the cycle") {
+			MockGraph graph;
+			parallel::NumaPlacement numaPlacement;
+			numaPlacement.pinThreads = true;
+			numaPlacement.replicateGraph = true;
+
+			auto searchedSolution = heuristic::parallel::scatterSearch(graph, NUMBER_OF_THREADS, NUMBER_OF_THREADS*3, 10, stop_function_factory::numberOfIterations(3), combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS, improvement_method_factory::localSearch(), construction_method_factory::heuristicSolution(), construction_method_factory::spanningTreeSolution(), 0, parallel::MigrationPolicy(), numaPlacement);
+
+			assert(searchedSolution.size(), ==, graph.getNumberOfVertices());
+			for (Vertex v = 0; v < searchedSolution.size(); v++) {
+				assert(searchedSolution[v], >=, 0);
+				assert(searchedSolution[v], <, graph.getCycle());
+			}
+		};
+
+		test_case("should throw error when replicating the graph without pinning threads") {
+			MockGraph graph;
+			parallel::NumaPlacement numaPlacement;
+			numaPlacement.replicateGraph = true;
+			bool exception_raised = false;
+			try {
+				heuristic::parallel::scatterSearch(graph, NUMBER_OF_THREADS, NUMBER_OF_THREADS*3, 10, stop_function_factory::numberOfIterations(1), combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS, improvement_method_factory::localSearch(), construction_method_factory::heuristicSolution(), construction_method_factory::spanningTreeSolution(), 0, parallel::MigrationPolicy(), numaPlacement);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+
+		test_case("exchanges should be due after interval iterations") {
+			parallel::MigrationPolicy migrationPolicy;
+			migrationPolicy.interval = 3;
+
+			assert(migrationPolicy.isDue(2, 10), ==, false);
+			assert(migrationPolicy.isDue(3, 0), ==, true);
+		};
+
+		test_case("exchanges on stagnation should be due once the penalty stagnated since the last exchange") {
+			parallel::MigrationPolicy migrationPolicy;
+			migrationPolicy.interval = 0;
+			migrationPolicy.stagnation = 4;
+
+			assert(migrationPolicy.isDue(10, 3), ==, false);
+			assert(migrationPolicy.isDue(2, 10), ==, false);
+			assert(migrationPolicy.isDue(4, 4), ==, true);
+		};
 	}
 };
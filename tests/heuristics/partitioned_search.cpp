@@ -0,0 +1,58 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+
+#define NUMBER_OF_VERTICES 200
+#define MIN_VERTEX_DEGREE 2
+#define MAX_VERTEX_DEGREE 5
+#define MIN_EDGE_WEIGHT 2
+#define MAX_EDGE_WEIGHT 13
+#define CYCLE 20
+#define NUMBER_OF_PARTS 4
+#define NUMBER_OF_THREADS 4
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+Graph* randomGraphFixture() {
+	auto graphBuilder = GraphBuilder(NUMBER_OF_VERTICES, MIN_VERTEX_DEGREE, MAX_VERTEX_DEGREE, MIN_EDGE_WEIGHT, MAX_EDGE_WEIGHT);
+	graphBuilder.withCycle(CYCLE);
+	return graphBuilder.buildAsAdjacencyList();
+}
+
+ConstructionMethod subproblemFixture() {
+	return [](const Graph& graph) -> Solution {
+		return activeVertexLocalSearch(graph, constructGreedySolution(graph));
+	};
+}
+
+tests {
+	test_suite("when performing partitioned search") {
+		test_case("solution should have all timings in the interval [0, cycle)") {
+			auto graph = randomGraphFixture();
+			auto solution = heuristic::parallel::partitionedSearch(*graph, NUMBER_OF_PARTS, subproblemFixture(), NUMBER_OF_THREADS);
+			assert(solution.size(), ==, graph->getNumberOfVertices());
+			for (auto timing : solution) {
+				assert((timing >= 0 && timing < CYCLE), ==, true);
+			}
+			delete graph;
+		};
+
+		test_case("solution should be better than a random solution") {
+			auto graph = randomGraphFixture();
+			auto solution = heuristic::parallel::partitionedSearch(*graph, NUMBER_OF_PARTS, subproblemFixture(), NUMBER_OF_THREADS);
+			assert(graph->totalPenalty(solution), <, graph->totalPenalty(constructRandomSolution(*graph)));
+			delete graph;
+		};
+
+		test_case("no vertex of the solution should have an improving move left") {
+			auto graph = randomGraphFixture();
+			auto solution = heuristic::parallel::partitionedSearch(*graph, NUMBER_OF_PARTS, subproblemFixture(), NUMBER_OF_THREADS);
+			for (Vertex v = 0; v < graph->getNumberOfVertices(); v++) {
+				assert(optimalTiming(*graph, v, solution).penalty, >=, graph->vertexPenalty(v, solution));
+			}
+			delete graph;
+		};
+	}
+};
@@ -0,0 +1,75 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+#define NUMBER_OF_PATHS 4
+#define NUMBER_OF_THREADS 2
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when relinking paths between solutions") {
+		test_case("relinked solution should only take timings from its parents") {
+			MockGraph graph;
+			auto a = constructRandomSolution(graph);
+			auto b = constructRandomSolution(graph);
+
+			auto relinkedSolution = pathRelinking(graph, a, b);
+
+			for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+				assert(relinkedSolution[v] == a[v] || relinkedSolution[v] == b[v], ==, true);
+			}
+		};
+
+		test_case("relinked solution should lie strictly between parents that differ in several vertices") {
+			MockGraph graph;
+			Solution a(graph.getNumberOfVertices(), 0);
+			Solution b(graph.getNumberOfVertices(), 1);
+
+			auto relinkedSolution = pathRelinking(graph, a, b);
+
+			assert(relinkedSolution == a, ==, false);
+			assert(relinkedSolution == b, ==, false);
+		};
+
+		test_case("relinking equal solutions should return the same solution") {
+			MockGraph graph;
+			auto a = constructRandomSolution(graph);
+			assert(pathRelinking(graph, a, a) == a, ==, true);
+		};
+
+		test_case("several relinking paths on several threads should keep the best one") {
+			MockGraph graph;
+			auto a = constructRandomSolution(graph);
+			auto b = constructRandomSolution(graph);
+			auto combineByPathRelinking = combination_method_factory::pathRelinking(NUMBER_OF_PATHS, NUMBER_OF_THREADS);
+
+			auto combinedSolution = combineByPathRelinking(graph, a, b);
+
+			assert(graph.totalPenalty(combinedSolution), <=, graph.totalPenalty(pathRelinking(graph, a, b)));
+			assert(graph.totalPenalty(combinedSolution), <=, graph.totalPenalty(pathRelinking(graph, b, a)));
+		};
+
+		test_case("scatter search should accept path relinking as combination method") {
+			MockGraph graph;
+			auto searchedSolution = scatterSearch(graph, 4, 8, 10, stop_function_factory::numberOfIterations(3), combination_method_factory::pathRelinking(NUMBER_OF_PATHS, NUMBER_OF_THREADS));
+			for (Vertex v = 0; v < searchedSolution.size(); v++) {
+				assert(searchedSolution[v], >=, 0);
+				assert(searchedSolution[v], <, graph.getCycle());
+			}
+		};
+
+		test_case("should throw error when number of paths is 0") {
+			bool exception_raised = false;
+			try {
+				combination_method_factory::pathRelinking(0);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+};
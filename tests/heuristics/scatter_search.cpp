@@ -106,6 +106,25 @@ tests {
 			assert(exception_raised, ==, true);
 		};
 
+		test_case("a search stopped at its first check should report and return its best initial elite") {
+			MockGraph graph;
+			bool reportedSolution = false;
+			TimeUnit reportedPenalty = 0, reportedSolutionPenalty = 0;
+			// unimproved random solutions, so the elite is not already in order
+			auto solution = scatterSearch(graph, 8, 2, 0, [&](const Metrics& metrics) {
+				reportedSolution = metrics.solution != nullptr;
+				if (reportedSolution) {
+					reportedPenalty = metrics.penalty;
+					reportedSolutionPenalty = graph.totalPenalty(*metrics.solution);
+				}
+				return false;
+			}, combination_method_factory::breadthFirstSearch(0.2), improvement_method_factory::localSearch(), construction_method_factory::randomSolution());
+
+			assert(reportedSolution, ==, true);
+			assert(reportedSolutionPenalty, ==, reportedPenalty);
+			assert(graph.totalPenalty(solution), ==, reportedPenalty);
+		};
+
 		test_case("scatter search solution should have at least one timing different from 0") {
 			MockGraph graph;
 			size_t elitePopulationSize = 4;
@@ -160,5 +179,24 @@ tests {
 				assert(timing, <, graph.getCycle());
 			}
 		};
+
+		test_case("scatter search with sketched distances should have all timings in the interval [0, cycle)") {
+			MockGraph graph;
+			size_t elitePopulationSize = 4;
+			size_t diversePopulationSize = 8;
+			size_t localSearchIterations = 10;
+			size_t sketchSize = 3;
+
+			auto stopFunction = stop_function_factory::numberOfIterations(3);
+			auto combinationMethod = combination_method_factory::breadthFirstSearch(0.2);
+
+			auto searchedSolution = scatterSearch(graph, elitePopulationSize, diversePopulationSize, localSearchIterations, stopFunction, combinationMethod, improvement_method_factory::localSearch(), construction_method_factory::heuristicSolution(), construction_method_factory::spanningTreeSolution(), sketchSize);
+
+			for (Vertex v = 0; v < searchedSolution.size(); v++) {
+				auto timing = searchedSolution[v];
+				assert(timing, >=, 0);
+				assert(timing, <, graph.getCycle());
+			}
+		};
 	}
 };
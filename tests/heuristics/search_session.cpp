@@ -0,0 +1,89 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include <heuristic/search_session.h>
+#include "mock_graph.h"
+
+#include <chrono>
+#include <thread>
+
+#define NUMBER_OF_THREADS 2
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+shared_ptr<const BestSolution> waitForBest (SearchSession& session) {
+	auto best = session.best();
+	for (unsigned attempt = 0; attempt < 1000 && !best; attempt++) {
+		this_thread::sleep_for(chrono::milliseconds(10));
+		best = session.best();
+	}
+	return best;
+}
+
+tests {
+	test_suite("when running a search session") {
+		test_case("the best solution should be readable while the search runs") {
+			MockGraph graph;
+			auto session = startScatterSearch(graph, 4, 4, 10, stop_function_factory::executionTime(chrono::hours(1)), combination_method_factory::breadthFirstSearch(0.2));
+
+			auto best = waitForBest(*session);
+
+			assert(best != nullptr, ==, true);
+			assert(session->isFinished(), ==, false);
+			assert(best->penalty, ==, graph.totalPenalty(best->solution));
+			session->cancel();
+			assert(graph.totalPenalty(session->wait()), <=, best->penalty);
+		};
+
+		test_case("cancelling should interrupt the local searches of the current iteration") {
+			MockGraph graph;
+			auto session = parallel::startScatterSearch(graph, NUMBER_OF_THREADS, NUMBER_OF_THREADS, 100000000, stop_function_factory::executionTime(chrono::hours(1)), combination_method_factory::breadthFirstSearch(0.2), NUMBER_OF_THREADS);
+
+			this_thread::sleep_for(chrono::milliseconds(50));
+			auto cancelBegin = chrono::high_resolution_clock::now();
+			session->cancel();
+			auto solution = session->wait();
+
+			assert(chrono::high_resolution_clock::now() - cancelBegin < chrono::seconds(1), ==, true);
+			assert(solution.size(), ==, graph.getNumberOfVertices());
+		};
+
+		test_case("a search cancelled while initializing its population should still leave a best solution") {
+			MockGraph graph;
+			// local searches long enough that the population is still being initialized when the session is cancelled
+			auto session = startScatterSearch(graph, 4, 4, 100000000, stop_function_factory::executionTime(chrono::hours(1)), combination_method_factory::breadthFirstSearch(0.2));
+
+			this_thread::sleep_for(chrono::milliseconds(50));
+			session->cancel();
+			auto solution = session->wait();
+
+			auto best = session->best();
+			assert(best != nullptr, ==, true);
+			assert(best->penalty, ==, graph.totalPenalty(solution));
+		};
+
+		test_case("a genetic algorithm reaching its stop function should leave its result as the best solution") {
+			MockGraph graph;
+			auto session = startGeneticAlgorithm(graph, 6, stop_function_factory::numberOfIterations(5), combination_method_factory::breadthFirstSearch(0.2));
+
+			auto solution = session->wait();
+
+			assert(session->isFinished(), ==, true);
+			assert(session->best()->penalty, ==, graph.totalPenalty(solution));
+		};
+
+		test_case("errors thrown by the search should be rethrown by wait") {
+			MockGraph graph;
+			auto session = startGeneticAlgorithm(graph, 1, stop_function_factory::numberOfIterations(5), combination_method_factory::breadthFirstSearch(0.2));
+			bool exception_raised = false;
+			try {
+				session->wait();
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+};
@@ -0,0 +1,119 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when hashing solutions") {
+		test_case("equal solutions should have equal hashes") {
+			MockGraph graph;
+			SolutionHasher solutionHasher;
+			auto solution = constructRandomSolution(graph);
+			auto copy = solution;
+			assert(solutionHasher.hash(solution), ==, solutionHasher.hash(copy));
+		};
+
+		test_case("moving one vertex should change the hash") {
+			MockGraph graph;
+			SolutionHasher solutionHasher;
+			Solution solution(graph.getNumberOfVertices(), 0);
+			auto hash = solutionHasher.hash(solution);
+			solution[2] = 1;
+			assert(solutionHasher.hash(solution), !=, hash);
+		};
+
+		test_case("incremental hash should match the hash of the moved solution") {
+			MockGraph graph;
+			SolutionHasher solutionHasher;
+			auto solution = constructRandomSolution(graph);
+			auto hash = solutionHasher.hash(solution);
+
+			auto oldTiming = solution[3];
+			solution[3] = (oldTiming+7)%graph.getCycle();
+			assert(solutionHasher.rehash(hash, 3, oldTiming, solution[3]), ==, solutionHasher.hash(solution));
+		};
+
+		test_case("duplicate solutions should be mutated until their hash is unique") {
+			MockGraph graph;
+			SolutionHasher solutionHasher;
+			mt19937 randomEngine(0);
+			auto solution = constructRandomSolution(graph);
+			auto original = solution;
+			SolutionHashSet hashes;
+			hashes.insert(solutionHasher.hash(solution));
+
+			auto hash = solutionHasher.mutateUntilUnique(graph, solution, solutionHasher.hash(solution), hashes, randomEngine);
+
+			assert(hashes.contains(hash), ==, false);
+			assert(hash, ==, solutionHasher.hash(solution));
+			assert(solution == original, ==, false);
+		};
+
+		test_case("unique solutions should be left untouched") {
+			MockGraph graph;
+			SolutionHasher solutionHasher;
+			mt19937 randomEngine(0);
+			auto solution = constructRandomSolution(graph);
+			auto original = solution;
+
+			solutionHasher.mutateUntilUnique(graph, solution, solutionHasher.hash(solution), SolutionHashSet(), randomEngine);
+
+			assert(solution == original, ==, true);
+		};
+	}
+
+	test_suite("when keeping a set of solution hashes") {
+		test_case("inserted hashes should be found, including 0, and duplicates counted once") {
+			SolutionHashSet hashes(4);
+			for (uint64_t hash : {0ul, 1ul, 17ul, 1ul << 40, 17ul, 0ul}) {
+				hashes.insert(hash);
+			}
+
+			assert(hashes.size(), ==, 4);
+			assert(hashes.contains(0), ==, true);
+			assert(hashes.contains(17), ==, true);
+			assert(hashes.contains(1ul << 40), ==, true);
+			assert(hashes.contains(2), ==, false);
+		};
+
+		test_case("hashes colliding on their slot should all be found") {
+			SolutionHashSet hashes(4);
+			// equal low bits send every hash to the same slot of the table
+			for (uint64_t i = 1; i <= 4; i++) {
+				hashes.insert(i << 32);
+			}
+
+			for (uint64_t i = 1; i <= 4; i++) {
+				assert(hashes.contains(i << 32), ==, true);
+			}
+			assert(hashes.contains(5ul << 32), ==, false);
+		};
+
+		test_case("set should grow past the size it was built for") {
+			SolutionHashSet hashes(2);
+			for (uint64_t hash = 1; hash <= 100; hash++) {
+				hashes.insert(hash*0x9e3779b97f4a7c15);
+			}
+
+			assert(hashes.size(), ==, 100);
+			for (uint64_t hash = 1; hash <= 100; hash++) {
+				assert(hashes.contains(hash*0x9e3779b97f4a7c15), ==, true);
+			}
+		};
+
+		test_case("cleared set should contain nothing") {
+			SolutionHashSet hashes(4);
+			hashes.insert(0);
+			hashes.insert(3);
+			hashes.clear();
+
+			assert(hashes.size(), ==, 0);
+			assert(hashes.contains(0), ==, false);
+			assert(hashes.contains(3), ==, false);
+		};
+	}
+};
@@ -0,0 +1,42 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when constructing spanning tree initial solution") {
+		test_case("solution should have one timing per vertex") {
+			MockGraph graph;
+			auto solution = constructSpanningTreeSolution(graph);
+			assert(solution.size(), ==, graph.getNumberOfVertices());
+		};
+
+		test_case("solution should have all timings in the interval [0, cycle)") {
+			MockGraph graph;
+			auto solution = constructSpanningTreeSolution(graph);
+			for (Vertex i = 0; i < graph.getNumberOfVertices(); i++) {
+				auto timing = solution[i];
+				assert((timing >= 0 && timing < testCycle), ==, true);
+			}
+		};
+
+		test_case("every vertex should have at least one edge at its minimum penalty") {
+			MockGraph graph;
+			auto solution = constructSpanningTreeSolution(graph);
+			for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+				bool hasTreeEdge = false;
+				for (auto& neighbor : graph.neighborsOf(v)) {
+					auto difference = ((solution[neighbor.first] - solution[v])%testCycle + testCycle)%testCycle;
+					if (difference == neighbor.second%testCycle || difference == (testCycle - neighbor.second%testCycle)%testCycle) {
+						hasTreeEdge = true;
+					}
+				}
+				assert(hasTreeEdge, ==, true);
+			}
+		};
+	}
+};
@@ -0,0 +1,85 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+// every heap allocation of this test binary, whichever thread makes it
+atomic<size_t> numberOfAllocations(0);
+
+void* operator new (size_t size) {
+	numberOfAllocations++;
+	if (void* memory = malloc(size > 0 ? size : 1)) {
+		return memory;
+	}
+	throw bad_alloc();
+}
+
+void operator delete (void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete (void* memory, size_t) noexcept {
+	free(memory);
+}
+
+/*
+ * Stops after numberOfIterations iterations, recording the allocations made up to the third iteration and up to the last one.
+ * By the third iteration every candidate has been combined and improved once, so the buffers of the search have all grown
+ */
+struct AllocationRecorder {
+	size_t numberOfIterations;
+	size_t allocationsAtThirdIteration = 0;
+	size_t allocationsAtLastIteration = 0;
+
+	StopFunction stopFunction (void) {
+		return [this](const Metrics& metrics) {
+			if (metrics.numberOfIterations == 3) {
+				this->allocationsAtThirdIteration = numberOfAllocations.load();
+			}
+			if (metrics.numberOfIterations == this->numberOfIterations) {
+				this->allocationsAtLastIteration = numberOfAllocations.load();
+			}
+			return metrics.numberOfIterations < this->numberOfIterations;
+		};
+	}
+};
+
+tests {
+	test_suite("when searching in steady state") {
+		test_case("scatter search iterations should not allocate with any of the built-in improvement methods") {
+			MockGraph graph;
+			for (auto& improvementMethod : {improvement_method_factory::localSearch(), improvement_method_factory::tabuSearch(3, 2), improvement_method_factory::activeVertexLocalSearch()}) {
+				AllocationRecorder recorder{20};
+				scatterSearch(graph, 4, 4, 10, recorder.stopFunction(), combination_method_factory::breadthFirstSearch(0.2), improvementMethod);
+				assert(recorder.allocationsAtThirdIteration, >, 0u);
+				assert(recorder.allocationsAtLastIteration, ==, recorder.allocationsAtThirdIteration);
+			}
+		};
+
+		test_case("scatter search iterations should not allocate when combining by crossover or path relinking") {
+			MockGraph graph;
+			for (auto& combinationMethod : {combination_method_factory::crossover(0.2), combination_method_factory::pathRelinking(3)}) {
+				AllocationRecorder recorder{20};
+				scatterSearch(graph, 4, 4, 10, recorder.stopFunction(), combinationMethod);
+				assert(recorder.allocationsAtThirdIteration, >, 0u);
+				assert(recorder.allocationsAtLastIteration, ==, recorder.allocationsAtThirdIteration);
+			}
+		};
+
+		test_case("genetic algorithm generations should not allocate") {
+			MockGraph graph;
+			AllocationRecorder recorder{20};
+			geneticAlgorithm(graph, 8, recorder.stopFunction(), combination_method_factory::breadthFirstSearch(0.2));
+			assert(recorder.allocationsAtThirdIteration, >, 0u);
+			assert(recorder.allocationsAtLastIteration, ==, recorder.allocationsAtThirdIteration);
+		};
+	}
+};
@@ -0,0 +1,63 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when using stop policies") {
+		test_case("stop functions created by the factory should expose their policy") {
+			auto stopFunction = stop_function_factory::numberOfIterations(25);
+			auto policy = stopFunction.target<stop_policy::NumberOfIterations>();
+			assert(policy, !=, nullptr);
+			assert(policy->numberOfIterationsToStop, ==, 25u);
+		};
+
+		test_case("cancellable stop functions should stop once cancelled") {
+			atomic<bool> cancelled(false);
+			auto stopFunction = stop_function_factory::cancellable(stop_function_factory::numberOfIterations(25), cancelled);
+			Metrics metrics;
+			metrics.numberOfIterations = 0;
+
+			assert(stopFunction.target<stop_policy::Cancellable<stop_policy::NumberOfIterations>>() != nullptr, ==, true);
+			assert(stopFunction(metrics), ==, true);
+			cancelled.store(true);
+			assert(stopFunction(metrics), ==, false);
+		};
+
+		test_case("amortized policy should eventually evaluate the wrapped policy") {
+			stop_policy::Amortized<stop_policy::NumberOfIterations> policy(stop_policy::NumberOfIterations{0});
+			Metrics metrics;
+			metrics.numberOfIterations = 0;
+			unsigned calls = 0;
+			while (policy(metrics) && calls < 1000000) {
+				calls++;
+			}
+			assert(calls, <, 1000000u);
+		};
+
+		test_case("local search templated on a stop policy should execute the requested number of iterations") {
+			MockGraph graph;
+			unsigned numberOfCalls = 0;
+			auto initialSolution = Solution(graph.getNumberOfVertices());
+			localSearchHeuristic(graph, initialSolution, [&](const Metrics& metrics) {
+				numberOfCalls++;
+				return metrics.numberOfIterations < 25;
+			});
+			assert(numberOfCalls, ==, 26u);
+		};
+
+		test_case("local search limited by execution time should stop shortly after the time limit") {
+			MockGraph graph;
+			auto initialSolution = Solution(graph.getNumberOfVertices());
+			auto begin = chrono::high_resolution_clock::now();
+			localSearchHeuristic(graph, initialSolution, stop_function_factory::executionTime(chrono::milliseconds(20)));
+			auto duration = chrono::high_resolution_clock::now() - begin;
+			assert(duration, >=, chrono::milliseconds(20));
+			assert(duration, <, chrono::milliseconds(200));
+		};
+	}
+};
@@ -0,0 +1,65 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <heuristic/heuristic.h>
+#include "mock_graph.h"
+#include <memory>
+
+using namespace traffic;
+using namespace std;
+using namespace heuristic;
+
+tests {
+	test_suite("when performing a tabu search") {
+		test_case("searched solution should be better than initial solution") {
+			MockGraph graph;
+			auto initialSolution = Solution(graph.getNumberOfVertices());
+			auto searchedSolution = tabuSearchHeuristic(graph, initialSolution, stop_function_factory::numberOfIterations(25));
+			assert(graph.totalPenalty(searchedSolution), <, graph.totalPenalty(initialSolution));
+		};
+
+		test_case("searched solution should never be worse than initial solution") {
+			MockGraph graph;
+			auto initialSolution = constructHeuristicSolution(graph);
+			auto searchedSolution = tabuSearchHeuristic(graph, initialSolution, stop_function_factory::numberOfIterations(100), 3, 2);
+			assert(graph.totalPenalty(searchedSolution), <=, graph.totalPenalty(initialSolution));
+		};
+
+		test_case("searched solution should have all timings in the interval [0, cycle)") {
+			MockGraph graph;
+			auto initialSolution = Solution(graph.getNumberOfVertices());
+			auto searchedSolution = tabuSearchHeuristic(graph, initialSolution, stop_function_factory::numberOfIterations(25));
+			for (Vertex v = 0; v < graph.getNumberOfVertices(); v++) {
+				auto timing = searchedSolution[v];
+				assert(timing, >=, 0);
+				assert(timing, <, graph.getCycle());
+			}
+		};
+
+		test_case("searches in a row on graphs of different sizes should each improve their own solution") {
+			auto graphBuilder = GraphBuilder(100, 2, 5, 2, 13);
+			graphBuilder.withCycle(testCycle*3);
+			unique_ptr<Graph> largerGraph(graphBuilder.buildAsAdjacencyList());
+			MockGraph graph;
+
+			// the tables left by each search are reused, resized, by the next one on the same thread
+			for (const Graph* searchedGraph : {(const Graph*) largerGraph.get(), (const Graph*) &graph, (const Graph*) largerGraph.get()}) {
+				auto initialSolution = constructRandomSolution(*searchedGraph);
+				auto searchedSolution = tabuSearchHeuristic(*searchedGraph, initialSolution, stop_function_factory::numberOfIterations(25));
+				assert(searchedGraph->totalPenalty(searchedSolution), <, searchedGraph->totalPenalty(initialSolution));
+				for (auto timing : searchedSolution) {
+					assert((timing >= 0 && timing < searchedGraph->getCycle()), ==, true);
+				}
+			}
+		};
+
+		test_case("tabu search should be usable as the scatter search improvement method") {
+			MockGraph graph;
+			Solution zeroTimingSolution(graph.getNumberOfVertices());
+			auto improvementMethod = improvement_method_factory::tabuSearch(3, 4);
+
+			auto searchedSolution = scatterSearch(graph, 4, 8, 10, stop_function_factory::numberOfIterations(3), combination_method_factory::breadthFirstSearch(0.2), improvementMethod);
+
+			assert(graph.totalPenalty(searchedSolution), <, graph.totalPenalty(zeroTimingSolution));
+		};
+	}
+};
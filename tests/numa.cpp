@@ -0,0 +1,60 @@
+#include <assertions-test/test.h>
+#include <parallel/numa.h>
+#include <parallel/reusable_thread.h>
+#include <stdexcept>
+
+using namespace parallel;
+using namespace std;
+
+tests {
+	test_suite("when reading the numa topology") {
+		test_case("cpu lists should expand ranges and single cpus") {
+			auto cpus = parse_cpu_list("0-2,5,8-9\n");
+
+			assert(cpus == vector<unsigned>({0, 1, 2, 5, 8, 9}), ==, true);
+		};
+
+		test_case("the detected topology should have at least one cpu on every node") {
+			numa_topology topology;
+
+			assert(topology.number_of_nodes(), >, 0);
+			for (unsigned node = 0; node < topology.number_of_nodes(); node++) {
+				assert(topology.cpus_of(node).size(), >, 0);
+			}
+		};
+
+		test_case("a node without cpus should throw invalid_argument") {
+			bool exception_raised = false;
+			try {
+				numa_topology topology({{0}, {}});
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+
+	test_suite("when pinning a thread pile") {
+		test_case("neighboring threads should share a node") {
+			numa_topology topology({{0}, {0}});
+			thread_pile threads(5, 2);
+
+			threads.pin(topology);
+
+			assert(threads.node_of(0), ==, 0);
+			assert(threads.node_of(2), ==, 0);
+			assert(threads.node_of(3), ==, 1);
+			assert(threads.node_of(4), ==, 1);
+		};
+
+		test_case("pinned threads should still run their tasks") {
+			thread_pile threads(2);
+			threads.pin(numa_topology());
+
+			auto ran = false;
+			threads[1].exec([&ran]() { ran = true; }).wait();
+
+			assert(ran, ==, true);
+		};
+	}
+};
@@ -0,0 +1,105 @@
+#include <assertions-test/test.h>
+#include <traffic_graph/traffic_graph.h>
+#include <partition/partition.h>
+#include <random>
+#include <cmath>
+
+#define GRID_SIDE 20
+#define NUMBER_OF_PARTS 4
+#define IMBALANCE_TOLERANCE 0.03
+#define CYCLE 20
+
+using namespace std;
+using namespace traffic;
+using namespace partition;
+
+// a grid splits into NUMBER_OF_PARTS squares cutting only 2*GRID_SIDE edges
+Graph* gridGraphFixture() {
+	GraphBuilder graphBuilder;
+	graphBuilder.withCycle(CYCLE);
+	for (Vertex row = 0; row < GRID_SIDE; row++) {
+		for (Vertex column = 0; column < GRID_SIDE; column++) {
+			Vertex v = row*GRID_SIDE + column;
+			if (column+1 < GRID_SIDE) {
+				graphBuilder.addEdge({v, v+1}, (v%7)+1);
+			}
+			if (row+1 < GRID_SIDE) {
+				graphBuilder.addEdge({v, v+GRID_SIDE}, (v%5)+1);
+			}
+		}
+	}
+	return graphBuilder.buildAsAdjacencyList();
+}
+
+tests {
+	test_suite("when partitioning a graph") {
+		test_case("every vertex should be assigned to a valid part") {
+			auto graph = gridGraphFixture();
+			auto partition = multilevelPartition(*graph, NUMBER_OF_PARTS, IMBALANCE_TOLERANCE);
+			assert(partition.size(), ==, graph->getNumberOfVertices());
+			for (auto part : partition) {
+				assert(part, <, NUMBER_OF_PARTS);
+			}
+			delete graph;
+		};
+
+		test_case("parts should respect the imbalance tolerance") {
+			auto graph = gridGraphFixture();
+			auto partition = multilevelPartition(*graph, NUMBER_OF_PARTS, IMBALANCE_TOLERANCE);
+			size_t maximumPartSize = ceil((1.0+IMBALANCE_TOLERANCE)*graph->getNumberOfVertices()/NUMBER_OF_PARTS);
+			for (auto& members : partMembers(partition, NUMBER_OF_PARTS)) {
+				assert(members.size(), >, 0);
+				assert(members.size(), <=, maximumPartSize);
+			}
+			delete graph;
+		};
+
+		test_case("cut should be much smaller than the cut of a random partition") {
+			auto graph = gridGraphFixture();
+			auto partition = multilevelPartition(*graph, NUMBER_OF_PARTS, IMBALANCE_TOLERANCE);
+
+			Partition randomPartition(graph->getNumberOfVertices());
+			mt19937 randomEngine(0);
+			for (auto& part : randomPartition) {
+				part = uniform_int_distribution<unsigned>(0, NUMBER_OF_PARTS-1)(randomEngine);
+			}
+
+			assert(edgeCut(*graph, partition)*4, <, edgeCut(*graph, randomPartition));
+			delete graph;
+		};
+
+		test_case("a single part should hold every vertex") {
+			auto graph = gridGraphFixture();
+			auto partition = multilevelPartition(*graph, 1);
+			assert(edgeCut(*graph, partition), ==, 0);
+			delete graph;
+		};
+
+		test_case("should throw error when there are more parts than vertices") {
+			auto graph = gridGraphFixture();
+			bool exception_raised = false;
+			try {
+				multilevelPartition(*graph, graph->getNumberOfVertices()+1);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+			delete graph;
+		};
+	}
+
+	test_suite("when building an induced subgraph") {
+		test_case("only edges between the given vertices should be kept, renumbered") {
+			auto graph = gridGraphFixture();
+			auto subgraph = buildInducedSubgraph(*graph, {0, 1, GRID_SIDE+1});
+			assert(subgraph->getNumberOfVertices(), ==, 3);
+			assert(subgraph->getCycle(), ==, CYCLE);
+			assert(subgraph->neighborsOf(0).size(), ==, 1);
+			assert(subgraph->neighborsOf(1).size(), ==, 2);
+			assert(subgraph->weight({0, 1}), ==, graph->weight({0, 1}));
+			assert(subgraph->weight({1, 2}), ==, graph->weight({1, GRID_SIDE+1}));
+			delete subgraph;
+			delete graph;
+		};
+	}
+};
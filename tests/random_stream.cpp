@@ -0,0 +1,96 @@
+#include <assertions-test/test.h>
+#include <rng/random_stream.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+tests {
+	test_suite("when generating bounded integers") {
+		test_case("all numbers should be in the interval [0, bound)") {
+			rng::bounded_stream stream(7);
+			for (unsigned i = 0; i < 10*rng::block_size; i++) {
+				auto number = stream();
+				assert(number, <, 7u);
+			}
+		};
+
+		test_case("every number in the interval should be generated") {
+			rng::bounded_stream stream(20);
+			vector<unsigned> occurrences(20, 0);
+			for (unsigned i = 0; i < 20000; i++) {
+				occurrences[stream()]++;
+			}
+			for (auto count : occurrences) {
+				assert(count, >, 0u);
+			}
+		};
+
+		test_case("bound of 1 should only generate 0") {
+			rng::bounded_stream stream(1);
+			for (unsigned i = 0; i < 2*rng::block_size; i++) {
+				assert(stream(), ==, 0u);
+			}
+		};
+
+		test_case("should throw error when the bound is 0") {
+			bool exception_raised = false;
+			try {
+				rng::bounded_stream stream(0);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+
+		test_case("should throw error when the bound does not fit in 32 bits") {
+			bool exception_raised = false;
+			try {
+				rng::bounded_stream stream(static_cast<size_t>(UINT32_MAX)+1);
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+		};
+	}
+
+	test_suite("when generating uniform doubles") {
+		test_case("all numbers should be in the interval [0, 1)") {
+			rng::uniform_stream stream;
+			for (unsigned i = 0; i < 10*rng::block_size; i++) {
+				auto number = stream();
+				assert(number, >=, 0.0);
+				assert(number, <, 1.0);
+			}
+		};
+
+		test_case("average should be close to 0.5") {
+			rng::uniform_stream stream;
+			double sum = 0;
+			unsigned numberOfSamples = 100000;
+			for (unsigned i = 0; i < numberOfSamples; i++) {
+				sum += stream();
+			}
+			assert(sum/numberOfSamples, >, 0.49);
+			assert(sum/numberOfSamples, <, 0.51);
+		};
+	}
+
+	test_suite("when seeding generators") {
+		test_case("generators with the same seed should generate the same numbers") {
+			rng::xoshiro256_lanes a(42), b(42);
+			for (unsigned i = 0; i < 100; i++) {
+				assert(a.next(), ==, b.next());
+			}
+		};
+
+		test_case("generators with different seeds should generate different numbers") {
+			rng::xoshiro256_lanes a(42), b(43);
+			bool foundDifference = false;
+			for (unsigned i = 0; i < 100 && !foundDifference; i++) {
+				foundDifference = a.next() != b.next();
+			}
+			assert(foundDifference, ==, true);
+		};
+	}
+};
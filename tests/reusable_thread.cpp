@@ -0,0 +1,96 @@
+#include <assertions-test/test.h>
+#include <parallel/macros.h>
+#include <parallel/reusable_thread.h>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace parallel;
+using namespace std;
+
+tests {
+	test_suite("when running tasks on a reusable thread") {
+		test_case("tasks should run in the order they were given") {
+			reusable_thread thread;
+			vector<int> order;
+			completion_token last;
+			for (int i = 0; i < 200; i++) {
+				last = thread.exec([&order, i]() { order.push_back(i); });
+			}
+			last.wait();
+
+			assert(order.size(), ==, 200);
+			for (int i = 0; i < 200; i++) {
+				assert(order[i], ==, i);
+			}
+		};
+
+		test_case("tasks too large to be stored inline should still run") {
+			reusable_thread thread;
+			array<long, 64> values;
+			values.fill(1);
+			long sum = 0;
+
+			thread.exec([values, &sum]() {
+				for (auto value : values) {
+					sum += value;
+				}
+			}).wait();
+
+			assert(sum, ==, 64);
+		};
+
+		test_case("every task given by several threads at once should run") {
+			reusable_thread consumer;
+			atomic<unsigned> numberOfRuns(0);
+			thread_pile producers(4);
+			using_threads(producers);
+
+			for_each_thread {
+				vector<completion_token> tokens;
+				for (unsigned i = 0; i < 1000; i++) {
+					tokens.push_back(consumer.exec([&numberOfRuns]() { numberOfRuns++; }));
+				}
+				wait_all(tokens);
+			} end_for_each_thread;
+
+			assert(numberOfRuns.load(), ==, 4000u);
+		};
+
+		test_case("get should rethrow what the task threw") {
+			reusable_thread thread;
+			auto token = thread.exec([]() { throw invalid_argument("task failed"); });
+			bool exception_raised = false;
+			try {
+				token.get();
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+			// the thread keeps running tasks after one threw
+			auto ran = false;
+			thread.exec([&ran]() { ran = true; }).get();
+			assert(ran, ==, true);
+		};
+
+		test_case("parallel loops should rethrow errors once every thread is done") {
+			thread_pile threads(3);
+			using_threads(threads);
+			atomic<unsigned> numberOfItems(0);
+			bool exception_raised = false;
+			try {
+				parallel_for ((size_t) 0, (size_t) 30) {
+					numberOfItems++;
+					if (i == 0) {
+						throw invalid_argument("item failed");
+					}
+				} end_parallel_for;
+			} catch (invalid_argument &e) {
+				exception_raised = true;
+			}
+			assert(exception_raised, ==, true);
+			assert(numberOfItems.load(), >=, 20u);
+		};
+	}
+};